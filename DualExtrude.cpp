@@ -1,503 +1,8540 @@
-// DualExtrude.cpp : Generate a "both extruders on" gcode file from a single extruder file
-// Copyright (c) 2012, Joe Cabana    Joey@JSConsulting.com
-
-/*
-Permission to use, copy, modify, and/or distribute this software for any
-purpose with or without fee is hereby granted, provided that the above
-copyright notice and this permission notice appear in all copies.
-
-THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
-WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
-MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
-ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
-WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
-ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
-OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
-*/
-
-
-/* 1.0
-  The basic idea here is to just duplicate the speed/temp/on/off commands
-  sent to one extruder to both extruders. The result should be two prints
-  for the time of one!
-*/
-
-/* 1.1
-  Of course the basic idea didn't quite make it. Both extruders came on, but the
-  second extruder speed wasn't correctly controlled. I added code derived from
-  "Dual Extrude Both Extruders at Once for Replicator" from user thorstadg
-  on thingiverse.com.  That did it!
-
-  That means that Dimension has to be enabled in skeinforge for this to work
-  since his code basically duplicated the extruder distance 'E' added by
-  Dimension so it worked for both extruders.
-*/
-
-/* 1.2
-  Minor bug fix in error messages and changes to eliminate deprecated conversion warnings
-*/
-
-/* 2.0
-  Added ability to adjust for differing filament diameters
-*/
-
-/* 2.1
-  Fixed a bug that generated an error on retracts early in the file.
-*/
-
-/* 2.2
-  Fixed a bug that showed the input file name when an error occured
-  creating the output file.
-*/
-
-// Include standard libs
-#include <stdio.h>
-#include <string.h>
-#include <math.h>
-
-// Local function prototypes
-int ConvFile(char *infile, char *outfile);
-int CheckFile(char *infile);
-int CheckCode(char *buf);
-
-// Local defines
-#define NUMCODES 7  // Number of g/m codes we care about
-#define NOTOKENS -1  // Code for no tokens found
-#define ERROR_BOTH "ERROR: File already uses both extruders.\n\n"
-#define M101	0	// Extruder on fwd
-#define M102	1	// Extruder on rev
-#define M103	2	// Extruder off
-#define M104	3	// Set temp
-#define M108	4	// Set extruder max speed
-#define M6		5	// Tool change
-#define G1		6	// Coordinated Motion
-
-// Command list  Should be same order as above defines
-const char *CODES[NUMCODES] = { "M101", "M102", "M103", "M104", "M108", "M6", "G1" };
-
-// Parse tokens
-char Tokens[] = " \012";
-
-// Extruder used flags
-int LeftUsed, RightUsed;  // Toolhead used indicators
-double FirstE;  // First 'E' position from source file
-double Ratio;  // Ratio of filament areas
-
-
-// Main() function
-// Input:  Command line args
-// Output: Success/Failure code
-int main(int argc, char* argv[])
-{
-	double D1, D2;  // Filament diameters
-	int InfileArg, OutFileArg;
-
-	// Clear varibles
-	LeftUsed = 0;
-	RightUsed = 0;
-	FirstE = 0;
-	Ratio = 1.0;
-
-	printf("DualExtrude version 2.2\n\n");
-
-	// Check args
-	switch (argc) {
-	case 3:  // Just file names
-		InfileArg = 1;  //  Set file name args
-		OutFileArg = 2;
-		break;
-	case 5:  // Also using diameters
-		InfileArg = 1;  // Set file name args
-		OutFileArg = 3;
-
-		// Get diameter ratio
-		sscanf(argv[2],"%lf",&D1);  // Get first diameter
-		if (D1 < 1.5 || D1 > 2.2) {
-			printf("ERROR: Filament diameter: %s too big/small!\n\n",argv[2]);
-			return (0);
-		}
-
-		sscanf(argv[4],"%lf",&D2);  // Get second diameter
-		if (D2 < 1.5 || D2 > 2.2) {
-			printf("ERROR: Filament diameter: %s too big/small!\n\n",argv[4]);
-			return (0);
-		}
-
-		// Calculate the ratio of the squares of the radius'
-		Ratio = ((D1 / 2) * (D1 / 2)) / ((D2 / 2) * (D2 / 2));
-		break;
-	default:   // Show usage
-		printf("Usage:  DualExtrude infile [DiaIn] outfile [DiaNew]\n\n");
-		printf("          infile - Input single extruder gcode file\n");
-		printf("          DiaIn - Diameter of filament used to generate the input file.\n");
-		printf("          outfile - Output both extruder gcode file\n");
-		printf("          DiaNew - Diameter of filament used on the second extruder.\n\n");
-		printf("    NOTE: If you are using different diameter filaments,\n");
-		printf("          BOTH DiaIn and DiaNew must be given!\n\n");
-		return (0);
-		break;
-	}
-
-	// Check/parse input file
-	printf("Checking file...\n");
-	if (!CheckFile(argv[InfileArg]))
-		return (-1);
-
-	if (LeftUsed)
-		printf("File uses left extruder, adding right...\n");
-	else
-		printf("File uses right extruder, adding left...\n");
-
-	if (argc == 5)
-		printf("Input file diameter: %s   Added extruder diameter: %s\n",argv[2],argv[4]);
-
-	// Generate new file
-	if (!ConvFile(argv[InfileArg],argv[OutFileArg]))
-		return (-1);
-
-	return (0);
-}
-
-// ConvFile() Function
-//   Reads single extruder input file
-//   and converts it two a "both on" file.
-//
-// Inputs: infile - File to convert
-//         outfile - Name for converted file
-//
-// Outputs: Sucess/Failure
-//
-int ConvFile(char *infile, char *outfile)
-{
-	FILE *in;  // Input file
-	FILE *out;  // Output file
-	int cnt = 0; // Line counter
-	char buf[1002];  // File buffer
-	char bufP[1002];  // Parse buffer
-	char *Token;  // Pointer for next token
-	const char *NotUsed;  // Toolhead code for the one
-					// that's not being used in the input file
-					// Used to drop lines we don't need
-	int Code;  // ID of the M code used in the current linw
-	int Temp;  // Arg from a set temp command
-	char Speed[16]; // Speed setting from speed command
-	double CurrentE;  // Current 'E' value
-	double NewE;  // 'E' for second extruder
-
-	// Set not used toolhead
-	if (RightUsed)
-		NotUsed = "T1";
-	else
-		NotUsed = "T0";
-
-	// Open input file
-	if ((in = fopen(infile,"r")) == NULL)
-	{
-		printf("ERROR: Can't open input file: %s\n\n",infile);
-		return (0);
-	}
-
-	// Open output file
-	if ((out = fopen(outfile,"wb")) == NULL)
-	{
-		fclose(in);
-		printf("ERROR: Can't create output file: %s\n\n",outfile);
-		return (0);
-	}
-
-	// Loop thru file
-	while (NULL != fgets(buf,1000,in))
-	{
-		++cnt;  // Increment line counter
-		strcpy(bufP,buf);  // Copy buffer for parsing
-
-		// Look for a command that we will need to deal with
-		switch (Code = CheckCode(strtok(bufP,Tokens)))
-		{
-		case M101:  // On/Off commands
-		case M102:
-		case M103:
-		case M6:  // Tool change
-			// Check for parameters
-			if (NULL != (Token = strtok(NULL,Tokens)))
-			{  // Has a second token, should be a "T0" or "T1"
-				if (!strcmp(NotUsed,Token)) // Check for used extruder
-					break;  // Command for unused extruder, drop it
-			}
-
-			// Needed command, duplicate for both extruders
-			sprintf(buf,"%s T1\012%s T0\012",CODES[Code],CODES[Code]);
-			break;
-		case M104:  // Temp command
-			Temp = 0;  // Zero temp
-
-			// Check for parameters
-			while (NULL != (Token = strtok(NULL,Tokens)))
-			{ // Got one!
-				if (!strcmp(NotUsed,Token)) // Check for unused extruder
-					break;  // Command for the "not used" extruder, drop it.
-
-				if ('S' == Token[0])  // Check for temp value
-					sscanf(Token,"S%d",&Temp);  // Get temp
-			}
-
-			// Needed temp command, output duplicates
-			sprintf(buf,"%s S%d T1\012%s S%d T0\012",CODES[Code],Temp,CODES[Code],Temp);
-			break;
-		case M108:  // Speed command
-			Speed[0] = 0;  // Clear speed
-
-			// Check for parameters
-			while (NULL != (Token = strtok(NULL,Tokens)))
-			{ // Got one!
-				if (!strcmp(NotUsed,Token)) // Check for unused extruder
-					break;  // Command for the "not used" extruder, drop it.
-
-				if ('R' == Token[0])  // Check for speed value
-				{
-					if (strlen(Token) > 15)  // Check for speed command that fits in buffer
-					{
-						fclose(in);
-						fclose(out);
-						printf("ERROR: Speed command too long in line %d\n\n",cnt);
-						return (0);
-					}
-					strcpy(Speed,Token);  // Get speed
-				}
-			}
-
-			if (!strlen(Speed))  // Check for a speed value
-			{
-				fclose(in);
-				fclose(out);
-				printf("ERROR: No speed in command in line %d\n\n",cnt);
-				return (0);
-			}
-
-			// Needed speed command, output duplicates
-			sprintf(buf,"%s %s T1\012%s %s T0\012",CODES[Code],Speed,CODES[Code],Speed);
-			break;
-		case G1:  // Coordinated Motion
-			sprintf(buf,"%s",CODES[G1]);  // Start command
-
-			// Check for parameters
-			while (NULL != (Token = strtok(NULL,Tokens)))
-			{ // Got one!
-				// The following is derived from "Dual Extrude Both Extruders at Once for Replicator"
-				// from user thorstadg on thingiverse.com
-				if ('E' == Token[0] || 'A' == Token[0] || 'B' == Token[0])  // Check for 'E', 'A' or 'B'
-				{
-					if (strlen(Token) > 15)  // Check for parameter that fits in buffer
-					{
-						fclose(in);
-						fclose(out);
-						printf("ERROR: E Parameter too long in line %d\n\n",cnt);
-						return (0);
-					}
-
-					// Get current 'E' value
-					CurrentE = 0.0;
-					sscanf(Token+1,"%lf",&CurrentE);
-
-/* Commented out to allow for retract on first/early moves
-					if (CurrentE < FirstE)  // Check for errors
-					{
-						fclose(in);
-						fclose(out);
-						printf("ERROR: E Parameter direction error in line %d\n\n",cnt);
-						return (0);
-					}
-*/
-
-					if (FirstE > 0) // Did we see an 'E' before?
-					{  // Yes, figure new value for second extruder
-						NewE = ((CurrentE - FirstE) * Ratio) + FirstE;
-
-						// Round to the nearest .001
-						NewE = floor((NewE * 100000.0) + 0.5);
-						NewE = NewE / 100000.0;
-
-						if (RightUsed)  // Check witch one is the new one
-						{
-							// Replace with A/B
-							sprintf(buf+strlen(buf)," B%.5f A%s", NewE, Token+1);
-						}
-						else
-						{
-							// Replace with A/B
-							sprintf(buf+strlen(buf)," A%.5f B%s", NewE, Token+1);
-						}
-					}
-					else
-					{  // No, just output what we got, and save the first 'E'
-						// Replace with A/B
-						sprintf(buf+strlen(buf)," A%s B%s",Token+1, Token+1);
-
-						FirstE = CurrentE; // Save first one
-					}
-				}
-				else  // Just output
-					sprintf(buf+strlen(buf)," %s",Token);
-			}
-			sprintf(buf+strlen(buf),"\012");
-			break;
-		}
-
-		// Output new/old line
-		fprintf(out,"%s",buf);
-	}
-
-	// Close flles
-	fclose(in);
-	fclose(out);
-
-	printf("%d Lines processed\n",cnt);
-
-	return (1);
-}
-
-// CheckFile() Function
-//   Reads single extruder input file
-//   and checks it to make sure one and
-//   only one extruder is used.
-//
-//   Sets RightUsed & Left Used globals
-//   as needed.
-//
-// Inputs: infile - File to convert
-//
-// Outputs: Sucess/Failure
-//
-int CheckFile(char *infile)
-{
-	FILE *in;  // Input file
-	int cnt = 0; // Line counter
-	char buf[1024];  // File buffer
-	char *Token;  // Pointer for next token
-	int UsedLeft, UsedRight, Temp;
-
-	// Open file
-	if ((in = fopen(infile,"r")) == NULL)
-	{
-		printf("ERROR: Can't open input file: %s\n\n",infile);
-		return (0);
-	}
-
-	// Loop thru file
-	while (NULL != fgets(buf,sizeof(buf),in))
-	{
-		++cnt;  // Increment line counter
-
-		// Look for a command that will tell us which toolhead is active
-		switch (CheckCode(strtok(buf,Tokens)))
-		{
-		case M101:  // On commands
-		case M102:
-			// Check for parameters
-			if (NULL != (Token = strtok(NULL,Tokens)))
-			{
-				if (!strcmp("T0",Token)) // Check for Right extruder
-				{
-					if (LeftUsed) {
-						printf(ERROR_BOTH);
-						fclose(in);
-						return (0);
-					}
-					RightUsed = 1;
-					break;
-				}
-				if (!strcmp("T1",Token)) // Check for Left extruder
-				{
-					if (RightUsed) {
-						printf(ERROR_BOTH);
-						fclose(in);
-						return (0);
-					}
-					LeftUsed = 1;
-					break;
-				}
-			}
-			break;
-		case M104:  // Temp command
-			UsedLeft = 0;
-			UsedRight = 0;
-			Temp = 0;
-			// Check for parameters
-			while (NULL != (Token = strtok(NULL,Tokens)))
-			{
-				if (!strcmp("T0",Token)) // Check for Right extruder
-					UsedRight = 1;
-
-				if (!strcmp("T1",Token)) // Check for Left extruder
-					UsedLeft = 1;
-
-				if ('S' == Token[0])  // Check for temp value
-					sscanf(Token,"S%d",&Temp);
-			}
-
-			// Check for right extruder active
-			if (UsedRight && Temp > 0)
-			{
-				if (LeftUsed) {
-					printf(ERROR_BOTH);
-					fclose(in);
-					return (0);
-				}
-				RightUsed = 1;
-				break;
-			}
-
-			// Check for left extruder active
-			if (UsedLeft && Temp > 0)
-			{
-				if (RightUsed) {
-					printf(ERROR_BOTH);
-					fclose(in);
-					return (0);
-				}
-				LeftUsed = 1;
-				break;
-			}
-			break;
-		}
-	}
-
-	// Close flle
-	fclose(in);
-
-	// Check to see if we found one
-	if (!RightUsed && !LeftUsed)
-	{
-		printf("ERROR: Couldn't find a used extruder!\n\n");
-		return (0);
-	}
-
-	printf("%d Lines checked...\n",cnt);
-
-	return (1);
-}
-
-// CheckCode() Function
-//   Checks a character string to see if it
-//   matches one of the known G/M codes.
-//
-// Inputs: buf - Input string
-//
-// Outputs: Code ID, or NOTOKENS if none found
-//
-int CheckCode(char *buf)
-{
-	int cnt;
-
-	if (NULL == buf) // Check for no mcodes
-		return (-1);
-
-	for (cnt = 0; cnt < NUMCODES; ++cnt)
-	{
-		// Check for G/M Code
-		if (!strcmp(buf,CODES[cnt]))
-			return (cnt);
-	}
-
-	return (NOTOKENS);
-}
+// DualExtrude.cpp : Generate a "both extruders on" gcode file from a single extruder file
+// Copyright (c) 2012, Joe Cabana    Joey@JSConsulting.com
+
+/*
+Permission to use, copy, modify, and/or distribute this software for any
+purpose with or without fee is hereby granted, provided that the above
+copyright notice and this permission notice appear in all copies.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+/* 1.0
+  The basic idea here is to just duplicate the speed/temp/on/off commands
+  sent to one extruder to both extruders. The result should be two prints
+  for the time of one!
+*/
+
+/* 1.1
+  Of course the basic idea didn't quite make it. Both extruders came on, but the
+  second extruder speed wasn't correctly controlled. I added code derived from
+  "Dual Extrude Both Extruders at Once for Replicator" from user thorstadg
+  on thingiverse.com.  That did it!
+
+  That means that Dimension has to be enabled in skeinforge for this to work
+  since his code basically duplicated the extruder distance 'E' added by
+  Dimension so it worked for both extruders.
+*/
+
+/* 1.2
+  Minor bug fix in error messages and changes to eliminate deprecated conversion warnings
+*/
+
+/* 2.0
+  Added ability to adjust for differing filament diameters
+*/
+
+/* 2.1
+  Fixed a bug that generated an error on retracts early in the file.
+*/
+
+/* 2.2
+  Fixed a bug that showed the input file name when an error occured
+  creating the output file.
+*/
+
+/* 3.0
+  Added a single pass mode (--single-pass) that reads and converts the input
+  file once instead of checking it first. Lines before the used extruder is
+  known are held in memory and written out as soon as it is found.
+
+  The input file is now mapped into memory when possible (buffered block
+  reads otherwise) and lines are parsed straight from it, without
+  strtok() or copying them first. G/M codes are looked up by number
+  instead of comparing against each known code. 'E' values are read and
+  written without sscanf()/sprintf(), with the same rounding as before.
+
+  Either file name can be '-' to use stdin/stdout, so DualExtrude can be
+  run in a pipe. Reading stdin always uses single pass mode. Messages go
+  to stderr when the output is stdout.
+
+  Added --threads N to convert on more than one core. Once the first 'E'
+  is known each line converts on its own, so the rest of the file is split
+  into blocks of whole lines that are converted at the same time and
+  written out in order. Needs a mapped input file and the two pass mode.
+
+  Added --batch listfile to convert many files in one run. Each line of
+  the list is "infile [DiaIn] outfile [DiaNew]", the same order as the
+  command line. The files are shared out over --threads threads, and a
+  thread that runs out of files takes them from the end of another
+  thread's list. The conversion state is now one copy per thread so the
+  files don't get mixed up.
+
+  Added --bench SPEC to measure conversion speed. It makes up a MakerWare
+  style file in memory and times reading, tokenizing, CheckCode(), the
+  conversion and writing on it. "scan CODES" times the lookup CheckCode()
+  replaced, comparing the first word with each of CODES in turn.
+
+  Output is collected in a large buffer (--outbuf, 8 MB by default) that
+  is written with one write() call when it fills, and converted lines go
+  straight into it. --write-thread writes on a second thread with two
+  buffers, so converting and writing overlap.
+
+  gzip and zstd input files are found by their magic numbers and
+  decompressed on their own thread a block ahead of the conversion.
+  Output files ending in .gz or .zst are compressed on the write thread.
+  Needs a build with -DUSE_ZLIB -lz and/or -DUSE_ZSTD -lzstd.
+
+  Lines can be any length now, they used to be split at 1000 chars (1024
+  when checking). The read buffer grows to fit the longest line, and G1
+  lines that convert to more than the usual room are converted again
+  with more, so long lines can't overrun the output buffer either.
+
+  Added --checkpoint, which saves the input/output offsets and the
+  conversion state in outfile.ckpt every 64 MB (and at the end), after
+  the output written so far is synced to disk. --resume carries on from
+  there, only checking and converting the rest of the input, so a killed
+  run doesn't start over and a file that has grown only converts what
+  was added.
+
+  Added --binary to write a compact binary file for printers that take
+  one. It starts with "DEGB" and a version byte (1), then records:
+    1 - G1 move: a mask byte (bit 0 X, 1 Y, 2 Z, 3 F, 4 A, 5 B), then the
+        fields in that order, X/Y/Z/F as 4 byte thousandths and A/B as 8
+        byte hundred-thousandths, little endian, only the ones in the mask.
+    2 - New string: length (varint), the line without its '\n'. Strings
+        are numbered from 0 in the order they're added.
+    3 - Repeated string: its number (varint).
+    4 - String that isn't in the table: length (varint) and the line.
+  Moves with anything else on the line, or values that can't be stored
+  exactly, are stored as strings. Varints are 7 bits a byte, low first.
+
+  Added --stats json, which shows one line of JSON for each file with the
+  time spent checking, converting and waiting on reads/writes, bytes in
+  and out, how many lines had each code, how many 'E's were rewritten and
+  the peak memory use.
+
+  The conversion can be used from other programs now. DualExtrude.h has
+  a DualExtruder class that is fed the file in pieces of any size and
+  passes the converted file to a callback, with its own copy of the
+  conversion state so many jobs can run at once. Build DualExtrude.cpp
+  with -DDUALEXTRUDE_NO_MAIN to link it into a program.
+
+  Runs of lines that don't change (comments, G0, G92 and anything else
+  without a code we convert) are found 64 bytes at a time, with AVX2 when
+  the CPU has it or NEON on ARM, and copied in one piece without being
+  split into words. -DNO_SIMD builds without the vector code.
+  Runs of 1MB or more, like embedded thumbnails, go from the input file
+  to the output file with copy_file_range()/sendfile() where the
+  system has them, so they never pass thru the output buffer.
+
+  Added --quick-check, which stops checking the file at the first command
+  that shows which toolhead is used, and checks the rest for the other
+  toolhead while converting. A file that uses both fails then, and the
+  part of the output file already written is removed.
+
+  Added --verify, which reads the converted file back and checks it against
+  the input on --threads N threads. Every line must be unchanged except the
+  toolhead commands and the moves, a move must keep all its words, and the
+  added A or B must match the filament ratio. The first line that doesn't is
+  reported and the conversion fails.
+
+  Added --heads N for IDEX and tool changer machines with up to 4 toolheads.
+  The commands are duplicated for each one, T2 and T3 get the 'C' and 'D'
+  axes, and DiaNew can be a list with a diameter for each added toolhead.
+  ConvLine() is a template on the number of toolheads, so the two toolhead
+  case is as quick as before.
+
+  Added --cache DIR for files that get converted again and again. The check
+  hashes the input as it reads it, and if DIR has a file converted from the
+  same input with the same settings, it's linked to the output file instead
+  of converting. New conversions are linked into DIR.
+
+  G92 E and the 'E' modes (M82/M83, G90/G91) are followed now. A G92 that
+  sets 'E' sets the added toolheads to where that 'E' puts them, and
+  relative 'E's are scaled as distances. Before, a G92 E0 was copied and
+  left the added toolheads where they were.
+
+  Added --index, which saves where each layer starts (each G1 with a new
+  Z) in outfile.idx: the input and output offsets, the line and the 'E'
+  state there. --from-layer N converts again from layer N, keeping the
+  output before it, so the added extruder diameters can be changed for
+  the top of a print without starting over. When they change, a G92 puts
+  the added toolheads where the new ratio has them first.
+
+  Added --read-thread, which reads the input a few blocks ahead on its own
+  thread instead of mapping it. With --write-thread, reading, converting
+  and writing all overlap, for slow or network storage. The threads pass
+  blocks thru rings that only need an atomic store to hand one over, and
+  the decompress thread and the write thread use them now too. The write
+  thread's ring has 4 --outbuf sized blocks, where it had 2 buffers.
+
+  Added --stream, for converting while the file is sent to the printer.
+  The toolhead comes from --tool T0|T1 instead of a check pass, input is
+  taken as it arrives, and each line goes out as soon as it's converted,
+  in batches of at most 64 lines when more are already waiting. The time
+  from reading each line to writing it is kept in a small histogram, and
+  the percentiles are shown at the end and in --stats.
+
+  Added --arena, which parses blocks of lines into commands first, one
+  array for each part of them (code, X/Y/Z/F and the 'E' for each toolhead
+  in fixed point, the text of the other lines), all from one arena that's
+  reused for each block. The conversion is a pass over those arrays, and
+  the moves are written back out from them, so more passes can be added
+  between the two without parsing the text again. Moves that wouldn't
+  print back exactly the same stay text.
+
+  Added --expect FILE, which compares the converted file with FILE and
+  fails at the first line that's different, so a set of files can be
+  checked against outputs known to be good. --bench takes min=MBPS and
+  fails if converting runs slower than that, and shows a hash of the
+  converted file, which only changes when the conversion does. The
+  files in tests/ are checked that way by tests/run_tests.sh, with each
+  option that shouldn't change the output, and with "default,min=".
+
+  Added timing hooks around each stage of converting a line: reading it,
+  classifying it with CheckCode(), rewriting the 'E's, formatting them
+  and writing the output. They're only there in a build with
+  -DDUALEXTRUDE_PROFILE. Then each thread times 1 in 16 calls of each
+  stage in CPU cycles, and the histograms are shown on stderr at exit.
+
+  Added --analyze, which reads the input once and writes nothing. It adds
+  up the G1 travel, a time estimate from the feed rates and the filament
+  each toolhead would use with the diameters given, on --threads N
+  threads. Each block keeps the positions it doesn't set as offsets from
+  where the one before it ended, and the few moves that need those are
+  finished when the blocks are added together.
+*/
+
+// Include standard libs
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <limits.h>
+
+#include <thread>
+#include <mutex>
+#include <chrono>
+#include <condition_variable>
+#include <atomic>
+#include <string>
+#include <unordered_map>
+
+#include "DualExtrude.h"
+
+#ifdef _WIN32
+#include <io.h>
+#include <fcntl.h>
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/resource.h>
+#endif
+#ifdef __linux__
+#include <sys/sendfile.h>
+#include <sys/ioctl.h>
+#include <linux/fs.h>
+#endif
+
+// Vector line scanning, see ScanSpan()
+#if defined(__GNUC__) && defined(__x86_64__) && !defined(NO_SIMD)
+#define SCAN_AVX2
+#include <immintrin.h>
+#elif defined(__aarch64__) && !defined(NO_SIMD)
+#define SCAN_NEON
+#include <arm_neon.h>
+#endif
+
+// Local defines
+#define VERSION "3.0"  // Shown at the start, and part of the --cache key
+#define MAXOUT 2048  // Room for the new line(s) from ConvLine(), past the line length
+#define MAXWORD 400  // Room ConvLine() needs for each G1 word, past its length
+#define PARSELEN 63  // Most chars of a value ParseE() hands to strtod()
+#define BLOCKSIZE (1024 * 1024)  // Read size when input can't be mapped
+#define SCANBLOCK 64  // Bytes ScanSpan() classifies at once
+#define SPANCOPY (1024 * 1024)  // Unchanged runs this long are copied by the kernel
+#define OUTBUFSIZE 8  // Default output buffer size in MB
+#define SINKBUFSIZE (64 * 1024)  // Output buffer size for DualExtruder
+#define MAXOUTBUF 256  // Largest output buffer in MB
+#define CHUNKSIZE (4 * 1024 * 1024)  // Input bytes per thread for --threads
+#define MAXTHREADS 256  // Most threads for --threads
+#define MAXHEADS 4  // Most toolheads for --heads, T0-T3 get 'A'-'D'
+#define CKPTSIZE (64 * 1024 * 1024)  // Input bytes between checkpoints
+#define HASHBLOCK (1024 * 1024)  // Mapped input is hashed this far behind the check, for --cache
+#define VERIFYTOL 0.0000051  // Most a new 'A'/'B' can be off by, PutFixed() rounds to .00001
+#define ZIPBLOCK (1024 * 1024)  // Decompressed/compressed block size
+#define RINGSLOTS 4  // Blocks in a BlockRing
+#define STREAMLINES 64  // Most lines --stream converts before writing them
+#define LATBUCKETS 512  // Latency histogram buckets, 8 for each power of 2 ns
+
+// How OpenIn() reads the file
+#define OPEN_MAP 0  // Mapped if possible, blocks otherwise
+#define OPEN_AHEAD 1  // Blocks read ahead on their own thread
+#define OPEN_LINES 2  // Whatever has arrived, for --stream
+
+// What RingWait() waits for
+#define RING_ROOM 0  // A free block to fill
+#define RING_DATA 1  // A filled block, or the end
+#define RING_IDLE 2  // All the filled blocks used
+#define ZIP_NONE 0  // File compression types
+#define ZIP_GZ 1
+#define ZIP_ZSTD 2
+#define BIN_MAGIC "DEGB\001"  // Binary format header, version 1
+#define BIN_MOVE 1  // Binary record types
+#define BIN_NEW 2
+#define BIN_REF 3
+#define BIN_ONCE 4
+#define BIN_X 0  // Move record fields, bit numbers in the mask
+#define BIN_Y 1
+#define BIN_Z 2
+#define BIN_F 3
+#define BIN_A 4
+#define BIN_B 5
+#define MAXREC 64  // Room for a move record
+#define CMDLINES 65536  // Lines in each CmdBlock for --arena
+#define MAXCMD 256  // Room PutBlock() needs for a move
+#define ARENACHUNK (8 * 1024 * 1024)  // Bytes an Arena gets from malloc() at once
+#define CMD_X 0  // CmdBlock fields, bit numbers in the mask
+#define CMD_Y 1
+#define CMD_Z 2
+#define CMD_F 3
+#define CMD_A 4  // 'E' for each toolhead, A-D
+#define CMD_FIELDS (CMD_A + MAXHEADS)
+#define CMD_NEW 8  // Mask bit for the added toolheads' 'E's going first
+#define CMD_DOT 15  // Places for a number without a '.'
+#define ANA_F 4  // Bit for the feed rate in AnaChunk Known, after X/Y/Z/E
+#define MAXSTRLEN 4096  // Longest string kept in the string table
+#define MAXSTRINGS 1000000  // Most strings in the string table
+#define NUMCODES 12  // Number of g/m codes we care about
+#define NOTOKENS -1  // Code for no tokens found
+#define ERROR_BOTH "ERROR: File already uses both extruders.\n\n"
+#define M101	0	// Extruder on fwd
+#define M102	1	// Extruder on rev
+#define M103	2	// Extruder off
+#define M104	3	// Set temp
+#define M108	4	// Set extruder max speed
+#define M6		5	// Tool change
+#define G1		6	// Coordinated Motion
+#define G92		7	// Set position
+#define M82		8	// Absolute 'E's
+#define M83		9	// Relative 'E's
+#define G90		10	// Absolute positions, 'E' too
+#define G91		11	// Relative positions, 'E' too
+
+// Optional timing of each stage, build with -DDUALEXTRUDE_PROFILE
+// The hooks are left out of other builds
+#ifdef DUALEXTRUDE_PROFILE
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#define PROFSTAGES 5  // Stages timed
+#define PROFSAMPLE 16  // Time 1 in this many calls, a power of 2
+#define PROF_READ 0  // Stages, same order as PROFNAMES
+#define PROF_CLASSIFY 1
+#define PROF_EREWRITE 2
+#define PROF_FORMAT 3
+#define PROF_WRITE 4
+#define PROF_START(Stage) ProfStart(Stage)
+#define PROF_END(Stage) ProfEnd(Stage)
+#else
+#define PROF_START(Stage)
+#define PROF_END(Stage)
+#endif
+
+// Optional compressed file support, build with
+// -DUSE_ZLIB -lz and/or -DUSE_ZSTD -lzstd
+#ifdef USE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef USE_ZSTD
+#include <zstd.h>
+#endif
+
+// Blocks passed from one thread to the next, one
+// filling them and the other using them. Passing
+// a block only takes an atomic store, a thread
+// only waits when there's nothing it can do
+struct BlockRing {
+	char *Blocks[RINGSLOTS];  // The blocks, Size bytes each
+	size_t Lens[RINGSLOTS];  // Bytes in each filled one
+	size_t Size;  // Bytes allocated for each
+	std::atomic<unsigned> Head;  // Blocks filled, only the filling thread changes it
+	std::atomic<unsigned> Tail;  // Blocks used, only the using thread changes it
+	std::atomic<int> Done;  // No more blocks coming
+	std::atomic<int> Stop;  // The using thread doesn't want any more
+	std::atomic<int> Sleepers;  // Threads in RingWait()
+	std::mutex Lock;  // Only for sleeping
+	std::condition_variable Wake;  // Signals Head/Tail/Done/Stop changes to sleepers
+};
+
+// Read thread for an input file, a few blocks ahead of
+// ReadLine(). It decompresses gzip/zstd files, and reads
+// plain ones in blocks for --read-thread
+struct InZip {
+	int Type;  // ZIP_GZ, ZIP_ZSTD or ZIP_NONE for a plain file
+	FILE *fp;  // Compressed file, NULL if mapped
+	const char *Map;  // Mapped compressed file
+	size_t MapSize;  // Bytes in Map
+	char *SrcBuf;  // Read buffer for fp
+	const char *Src;  // Compressed data
+	size_t SrcLen;  // Bytes in Src
+	size_t SrcPos;  // Next compressed byte
+#ifdef USE_ZLIB
+	z_stream Gz;  // gzip decompressor
+#endif
+#ifdef USE_ZSTD
+	ZSTD_DStream *Zs;  // zstd decompressor
+	size_t ZsHint;  // 0 when the last frame is finished
+#endif
+	int Ended;  // End of the compressed data
+	int Failed;  // Read error or bad data
+
+	std::thread Reader;  // Read/decompress thread
+	BlockRing Ring;  // Blocks from the thread to ReadIn()
+	char *Block;  // Block ReadIn() is using, NULL if none
+	size_t BlockLen;  // Bytes in Block
+	size_t BlockPos;  // Next byte in Block
+};
+
+// Input file, mapped into memory when possible
+struct InFile {
+	FILE *fp;  // File for buffered reads, NULL when mapped
+	char *Data;  // Mapped file or read buffer
+	size_t Size;  // Bytes in Data
+	size_t Pos;  // Start of the next line in Data
+	size_t Alloc;  // Bytes allocated for a read buffer, grows for long lines
+	unsigned long long Base;  // File offset of Data[0]
+	int Mapped;  // Data is a memory mapping
+	int fd;  // The mapped file, kept open for CopySpan()
+	int Eof;  // Nothing left to read
+	int Failed;  // Read error
+	int ByLine;  // Take what's there instead of filling the buffer, for --stream
+	InZip *Zip;  // Decompressor, NULL if not compressed
+};
+
+// Where a conversion got to, saved in outfile.ckpt
+struct ConvCkpt {
+	unsigned long long InPos;  // Input bytes converted, always whole lines
+	unsigned long long OutPos;  // Output bytes written for them
+	int Lines;  // Lines converted
+	int LeftUsed, RightUsed;  // Conversion state at that point
+	double FirstE;
+	int RelativeE;
+	int Heads;  // --heads it was made with
+	double Ratio[MAXHEADS - 1];
+	int SetE;  // Set the added toolheads from LastE first, the ratio changed
+	double LastE;  // 'E' position at InPos, for SetE
+};
+
+// Start of a layer, for --index
+struct LayerMark {
+	int Layer;  // Layer number, from 1
+	double Z;  // Its height
+	ConvCkpt At;  // Where it starts, and the state to carry on from there
+};
+
+// Layers found so far, saved in outfile.idx
+struct LayerIndex {
+	LayerMark *Marks;  // In file order
+	int Num;  // Marks used
+	int Size;  // Marks allocated
+};
+
+
+// Output file, collected in a large buffer
+// that is written out in one piece when it fills
+struct OutFile {
+#ifdef _WIN32
+	FILE *fp;  // Unbuffered file
+#else
+	int fd;  // File descriptor
+#endif
+	int IsStdout;  // Writing to stdout, don't close it
+	DualSink Sink;  // Called with the output instead of writing a file, NULL if not
+	void *SinkCtx;  // Passed to Sink
+	char *Buf;  // Buffer being filled
+	size_t Len;  // Bytes in Buf
+	size_t Size;  // Bytes allocated for Buf
+	int Failed;  // Write error
+	unsigned long long Written;  // Bytes in the file, after any compression
+	unsigned long long Kept;  // Bytes kept from the last run
+	unsigned long long Queued;  // Bytes added so far, before any compression
+	char *CkptName;  // Checkpoint file, NULL if not saving checkpoints
+	char *IdxName;  // Layer index file, NULL if not making one
+	LayerIndex Layers;  // Layers found for IdxName
+	unsigned long long CkptIn;  // Input offset of the last checkpoint
+	char *Big;  // Lines too long for Buf are converted here
+	size_t BigSize;  // Bytes allocated for Big
+	std::unordered_map<std::string,unsigned long> Strings;  // String table for --binary
+
+	// Compression, picked from the file name
+	int Zip;  // ZIP_NONE, ZIP_GZ or ZIP_ZSTD
+	char *ZipBuf;  // Compressed data
+#ifdef USE_ZLIB
+	z_stream Gz;  // gzip compressor
+#endif
+#ifdef USE_ZSTD
+	ZSTD_CCtx *Zs;  // zstd compressor
+#endif
+
+	// Write thread, writes the full buffers while the next one fills
+	int Threaded;  // Using the write thread
+	std::thread Writer;  // Write thread
+	BlockRing Ring;  // Buffers for it, Buf is the one being filled
+};
+
+// Running hash of the input for --cache, XXH64
+struct InHash {
+	unsigned long long Acc[4];  // One for each 8 bytes of a stripe
+	unsigned char Buf[32];  // Partial stripe
+	size_t BufLen;  // Bytes in Buf
+	unsigned long long Total;  // Bytes hashed
+};
+
+// Counters for --stats, one copy for each thread
+struct ConvStats {
+	double Start;  // Time the file was started
+	double CheckTime;  // Seconds checking the file
+	double ConvTime;  // Seconds converting it
+	double VerifyTime;  // Seconds checking the output for --verify
+	double IoWait;  // Seconds waiting on reads and writes
+	unsigned long long BytesIn;  // Input bytes converted
+	unsigned long long BytesOut;  // Bytes written
+	int Lines;  // Lines converted
+	unsigned long Codes[NUMCODES];  // Lines with each code, same order as CODES
+	unsigned long Rewrites;  // 'E's rewritten for the added extruders
+	int Cached;  // Linked from the --cache, not converted
+	int Streamed;  // Converted with --stream, the latencies are set
+	int Analyzed;  // --analyze, the totals are set
+	int Moves;  // G1s
+	double Travel;  // G1 distance in mm
+	double PrintTime;  // Estimated seconds
+	double Filament[MAXHEADS];  // mm of filament for each toolhead
+	double LatP50, LatP90, LatP99, LatMax;  // Line latencies in seconds
+};
+
+// Line latencies for --stream, the buckets are 1/8th
+// of a power of 2 ns wide so any time fits
+struct LatencyHist {
+	unsigned long long Counts[LATBUCKETS];
+	unsigned long long Total;  // Lines counted
+	double Max;  // Longest in seconds
+};
+
+// Lines held until the used toolhead is known,
+// each one after its length
+struct HeldLines {
+	char *Data;  // The lines
+	size_t Len;  // Bytes used in Data
+	size_t Size;  // Bytes allocated for Data
+};
+
+// Memory handed out in pieces and freed all at once
+struct ArenaChunk {
+	ArenaChunk *Next;  // Chunk before it
+	size_t Size;  // Bytes after the header
+	size_t Used;  // Bytes handed out
+	size_t Pad;  // Keeps what's after the header 16 byte aligned
+};
+
+struct Arena {
+	ArenaChunk *Head;  // Chunk being handed out, NULL if none
+};
+
+// Lines parsed into commands for --arena, one array for
+// each part so a pass only goes thru the parts it uses.
+// Moves have their fields in Val, the others stay text.
+struct CmdBlock {
+	int Num;  // Commands in the block
+	signed char *Code;  // CheckCode() value, NOTOKENS if none
+	unsigned short *Mask;  // Fields in Val and CMD_NEW, 0 for text
+	unsigned int *Places;  // Decimal places of each field as written, 4 bits each
+	long long *Val[CMD_FIELDS];  // X/Y/Z/F in .001 units, 'E's in .00001 units
+	const char **Text;  // The line, or the new line(s) for text after ConvBlock()
+	size_t *TextLen;  // Length of Text
+};
+
+#ifdef DUALEXTRUDE_PROFILE
+// Stage times for one thread, kept until the
+// end so threads that are done still get shown
+struct ProfThread {
+	ProfThread *Next;  // Thread that started before it
+	int Id;  // Threads started before it
+	unsigned long long Calls[PROFSTAGES];  // Times each stage was started
+	unsigned long long At[PROFSTAGES];  // When a timed one started, 0 if not timing it
+	unsigned long long Counts[PROFSTAGES][64];  // Timed calls by the highest bit of their time
+	unsigned long long Total[PROFSTAGES];  // Sum of the timed calls
+	unsigned long long Max[PROFSTAGES];  // Longest timed call
+};
+#endif
+
+// Move in an AnaChunk that needs the position
+// before the block to be figured
+struct AnaMove {
+	double D[4];  // X/Y/Z/E change, less the start position where Entry has a bit
+	int Entry;  // Bit for each of D, and 1 << ANA_F to use the feed rate before the block
+	double F;  // Feed rate, if known
+};
+
+// Block of lines added up by one thread for --analyze
+struct AnaChunk {
+	const char *Start;  // First line
+	const char *End;  // End of the last line
+	int RelXYZ, RelativeE;  // Modes from the block before
+	int EndRelXYZ, EndRelativeE;  // Modes after the block, for the next one
+	int Known;  // Bit for each of X/Y/Z/E and ANA_F the block sets
+	double Pos[5];  // X/Y/Z/E and feed rate at the end, as offsets from the start if not Known
+	AnaMove Defer[4];  // Moves that need the start position, each sets one more
+	int NumDefer;
+	double Dist;  // G1 travel in mm
+	double Time;  // Seconds for the moves with a known feed rate
+	double NoFeed;  // mm moved before the block sets a feed rate
+	double Filament;  // 'E' moved by the used toolhead
+	int Moves;  // G1s
+	int Lines;  // Lines in the block
+	int LeftUsed, RightUsed;  // Toolheads turned on in the block
+	int Both;  // Both were turned on
+};
+
+// Block of lines converted by one thread
+struct ConvChunk {
+	const char *Start;  // First line to convert
+	const char *End;  // End of the last line
+	int FirstLine;  // Line number of the first line, 0 to not report errors
+	int LeftUsed, RightUsed;  // Conversion state from the main thread
+	double FirstE;
+	int RelativeE;
+	double Ratio[MAXHEADS - 1];
+	FILE *Msg;
+	int Index;  // Note the layers for --index
+	LayerIndex Zs;  // Layers found, offsets from the start of the block
+	double EndFirstE;  // 'E' state after the block, for the next one
+	int EndRelativeE;
+	int Lines;  // Lines converted
+	int Failed;  // Conversion error
+	char *Out;  // Converted lines
+	size_t OutLen;  // Bytes used in Out
+	size_t OutSize;  // Bytes allocated for Out
+	ConvStats Stats;  // Counters from the thread
+};
+
+// Block of a converted file checked by one thread for --verify
+struct VerifyChunk {
+	const char *In;  // First input line
+	const char *InEnd;  // End of the last one
+	const char *Out;  // Output lines they should have made
+	const char *OutEnd;  // End of them
+	int FirstLine;  // Line number of the first input line
+	int OutLine;  // Line number of the first output line
+	int RightUsed;  // Conversion state from the main thread
+	double FirstE;  // First 'E' from before the block
+	double Ratio[MAXHEADS - 1];
+	double E;  // First 'E' while checking
+	int RelativeE;  // 'E's are distances, at the start and while checking
+	int Failed;  // Didn't match
+	int BadLine;  // Input line that didn't
+	int BadOut;  // Where its output is
+	const char *Why;  // What was wrong
+};
+
+// File to convert in batch mode
+struct BatchJob {
+	char *infile;  // File to convert
+	char *outfile;  // Name for converted file
+	char *DiaIn;  // Input filament diameter, NULL if not given
+	char *DiaNew;  // Added extruder diameter, NULL if not given
+	int Ok;  // Converted
+};
+
+// List of jobs for one batch thread, the owner takes
+// from the front and other threads steal from the back
+struct BatchQueue {
+	std::mutex Lock;  // Protects Head/Tail
+	int *Jobs;  // Job numbers
+	int Head;  // Next job for the owner
+	int Tail;  // End of the list
+};
+
+// Word from a line, points into the line
+struct GToken {
+	const char *Ptr;  // Start of the word
+	size_t Len;  // Length of the word
+	char Letter;  // First char, the G/M/parameter letter
+	const char *Num;  // Rest of the word, the value
+	size_t NumLen;  // Length of the value
+};
+
+// Line being split into words by NextToken()
+struct GLine {
+	const char *Cur;  // Where to look for the next word
+	const char *End;  // End of the line
+};
+
+// New line being built by the Put*() functions
+struct OutLine {
+	char *Start;  // Start of the buffer
+	char *Cur;  // Where the next char goes
+};
+
+// Finds the '\n's and possible command starts in a SCANBLOCK
+typedef void (*ScanFunc)(const char *p, unsigned long long *Ends, unsigned long long *Starts, unsigned long long *Gs);
+
+// Local function prototypes
+int GetRatio(const char *DiaIn, const char *DiaNew);
+int DoConv(char *infile, char *outfile, const char *DiaIn, const char *DiaNew, int SinglePass);
+int RunBatch(char *listfile, int SinglePass);
+void BatchThread(BatchQueue *Queues, BatchJob *Jobs, int NumQueues, int Id, int SinglePass);
+int ConvFile(char *infile, char *outfile, const ConvCkpt *From);
+int ConvFileOnePass(char *infile, char *outfile);
+int ConvFileStream(char *infile, char *outfile);
+void AddLatency(LatencyHist *Hist, double Secs);
+double LatencyAt(const LatencyHist *Hist, double Part);
+int HoldLine(HeldLines *Held, const char *Line, size_t Len, int cnt);
+int PutHeld(HeldLines *Held, OutFile *out);
+int ConvParallel(InFile *in, OutFile *out, int *cnt);
+int PutLine(OutFile *out, const char *Line, size_t Len, int cnt, int Check);
+int PutBinLine(OutFile *out, const char *Line, size_t Len, int cnt, int Check);
+int ConvText(OutFile *out, const char *Line, size_t Len, int cnt, int Check, const char **Text, size_t *TextLen);
+int ConvArena(InFile *in, OutFile *out, int *cnt, int Check);
+int StartBlock(CmdBlock *Block, Arena *Mem, int Size);
+void AddCmd(CmdBlock *Block, const char *Line, size_t Len);
+int CmdNum(const char *p, size_t Len, int Scale, long long *Val, int *Places);
+int ConvBlock(CmdBlock *Block, Arena *Mem, OutFile *out, int cnt, int Check);
+void PutBlock(OutFile *out, const CmdBlock *Block);
+void PutNum(OutLine *Out, long long Val, int Scale, int Places);
+void *ArenaAlloc(Arena *Mem, size_t Len);
+void ArenaReset(Arena *Mem);
+void ArenaFree(Arena *Mem);
+size_t PutMove(GLine *Parse, char *buf);
+void PutString(OutFile *out, const char *Str, size_t Len);
+char *PutLE(char *p, unsigned long long Val, int Bytes);
+char *PutVarint(char *p, unsigned long long Val);
+void ConvChunkLines(ConvChunk *Chunk);
+int AnalyzeFile(char *infile);
+void AnalyzeChunk(AnaChunk *Chunk);
+void AnalyzeLines(AnaChunk *Chunk, InFile *in);
+void AnalyzeMove(AnaChunk *Chunk, GLine *Parse);
+void AddMove(AnaChunk *Chunk, const double *D, double F, int FKnown);
+int VerifyFile(char *infile, char *outfile);
+int CompareOut(const char *outfile, const char *Expect);
+void VerifyThread(VerifyChunk *Chunks, int NumChunks, std::atomic<int> *Next, std::atomic<int> *FirstBad);
+int VerifyLines(VerifyChunk *Chunk);
+int VerifyLine(VerifyChunk *Chunk, const char *Line, size_t Len, InFile *out);
+int VerifyMove(VerifyChunk *Chunk, GLine *Parse, InFile *out, int Code);
+int VerifyNext(VerifyChunk *Chunk, InFile *out, const char *Want, size_t Len);
+int VerifyFail(VerifyChunk *Chunk, const char *Why);
+int VerifyCount(const char *Line, size_t Len, double *E, int *RelativeE);
+double VerifyNum(const char *p, size_t Len);
+const char *SkipLines(const char *p, const char *End, int n);
+int CountLines(const char *p, const char *End);
+char *CacheFile(unsigned long long InSum, const char *outfile);
+int CacheLink(const char *From, const char *To);
+void HashStart(InHash *Hash);
+void HashAdd(InHash *Hash, const char *Data, size_t Len);
+unsigned long long HashEnd(InHash *Hash);
+unsigned long long HashRound(unsigned long long Acc, unsigned long long Val);
+unsigned long long HashGet(const unsigned char *p);
+unsigned long long HashRot(unsigned long long Val, int Bits);
+char *CkptFile(const char *outfile);
+int LoadCkpt(const char *outfile, ConvCkpt *Ckpt);
+int NextCkpt(InFile *in, OutFile *out, int cnt);
+char *IndexFile(const char *outfile);
+int LoadIndex(const char *outfile, LayerIndex *Index);
+int SaveIndex(OutFile *out);
+int AddLayer(LayerIndex *Index, double Z, const ConvCkpt *At);
+void StateAt(ConvCkpt *At, unsigned long long InPos, unsigned long long OutPos, int Lines);
+int MoveZ(const char *Line, size_t Len, double *Z);
+int LayerStart(char *infile, const char *outfile, ConvCkpt *Ckpt);
+int FindLastE(char *infile, const ConvCkpt *From, unsigned long long To, double *E);
+int SaveCkpt(InFile *in, OutFile *out, int cnt);
+int ConvLine(const char *Line, size_t Len, char *buf, size_t Room, size_t *OutLen, int cnt, int Check);
+template <int Heads> int ConvHeads(const char *Line, size_t Len, char *buf, size_t Room, size_t *OutLen, int cnt, int Check);
+template <int Heads> void PutTools(OutLine *Out, const char *Cmd);
+int CheckFile(char *infile, unsigned long long From, InHash *Hash);
+int CheckLine(const char *Line, size_t Len);
+int CheckCode(const GToken *Token);
+void StartLine(GLine *Parse, const char *Line, size_t Len);
+int NextToken(GLine *Parse, GToken *Token);
+int TokenIs(const GToken *Token, const char *Str);
+int ParseInt(const char *p, size_t Len, int *Val);
+double ParseE(const char *p, size_t Len);
+int ParseFixed(const char *p, size_t Len, int Places, long long *Val);
+void StartOut(OutLine *Out, char *buf);
+void PutSpan(OutLine *Out, const char *Str, size_t Len);
+void PutStr(OutLine *Out, const char *Str);
+void PutChar(OutLine *Out, char c);
+void PutInt(OutLine *Out, int Val);
+void PutDigits(OutLine *Out, unsigned long long Val, int Min);
+void PutFixed(OutLine *Out, double Units);
+int OpenIn(InFile *in, const char *infile, int How);
+int ReadLine(InFile *in, const char **Line, size_t *Len);
+int LineReady(const InFile *in);
+int ReadSpan(InFile *in, const char **Span, size_t *Len, int CheckOnly);
+size_t ScanSpan(const char *p, const char *End, int CheckOnly, int *Lines);
+int SpanStop(const char *Line, const char *End, int CheckOnly);
+void ScanScalar(const char *p, unsigned long long *Ends, unsigned long long *Starts, unsigned long long *Gs);
+unsigned long long ByteMask(unsigned long long Word, char c);
+#ifdef SCAN_AVX2
+void ScanAvx2(const char *p, unsigned long long *Ends, unsigned long long *Starts, unsigned long long *Gs);
+#endif
+#ifdef SCAN_NEON
+void ScanNeon(const char *p, unsigned long long *Ends, unsigned long long *Starts, unsigned long long *Gs);
+#endif
+ScanFunc PickScan(void);
+int CountBits(unsigned long long Bits);
+int LowBit(unsigned long long Bits);
+int HighBit(unsigned long long Bits);
+void CloseIn(InFile *in);
+size_t ReadIn(InFile *in, char *Dest, size_t Max);
+int SkipIn(InFile *in, unsigned long long Pos);
+int ZipType(const char *Data, size_t Len);
+int OpenZip(InFile *in, int Type, FILE *fp, const char *Map, size_t MapSize);
+void ZipThread(InZip *Zip);
+size_t ZipSrc(InZip *Zip);
+size_t ZipFill(InZip *Zip, char *Dest, size_t Max);
+void CloseZip(InZip *Zip);
+int RingAlloc(BlockRing *Ring, size_t Size);
+void RingRelease(BlockRing *Ring);
+char *RingSpace(BlockRing *Ring);
+void RingPut(BlockRing *Ring, size_t Len);
+void RingEnd(BlockRing *Ring);
+char *RingGet(BlockRing *Ring, size_t *Len);
+void RingDone(BlockRing *Ring);
+void RingStop(BlockRing *Ring);
+void RingWait(BlockRing *Ring, int Want);
+int RingReady(BlockRing *Ring, int Want);
+void RingWake(BlockRing *Ring);
+OutFile *OpenOut(const char *outfile, unsigned long long Keep);
+OutFile *OpenSink(DualSink Sink, void *Ctx);
+OutFile *NewOut(size_t Size, int Threaded);
+void FreeOut(OutFile *out);
+int OutZip(const char *outfile);
+int CloseOut(OutFile *out);
+char *OutSpace(OutFile *out, size_t Need);
+void PutOut(OutFile *out, const char *Data, size_t Len);
+void CopySpan(OutFile *out, InFile *in, const char *Span, size_t Len);
+void WaitOut(OutFile *out);
+void FlushOut(OutFile *out);
+int SyncOut(OutFile *out);
+void WriteThread(OutFile *out);
+void WriteBlock(OutFile *out, const char *Data, size_t Len);
+int StartZip(OutFile *out);
+void ZipBlock(OutFile *out, const char *Data, size_t Len, int Finish);
+void WriteRaw(OutFile *out, const char *Data, size_t Len);
+void EnterJob(DualState *State);
+void LeaveJob(DualState *State);
+int FeedLine(DualState *State, const char *Line, size_t Len);
+int CarryLine(DualState *State, const char *Data, size_t Len);
+void AddStats(ConvStats *To, const ConvStats *From);
+void PrintStats(const char *infile, const char *outfile, int Ok);
+void PutJson(const char *Str);
+int RunBench(const char *Spec);
+char *GenGCode(size_t Size, const int *Mix, int EPct, size_t *Len, int *Lines);
+double GetTime(void);
+#ifdef DUALEXTRUDE_PROFILE
+void ProfStart(int Stage);
+void ProfEnd(int Stage);
+ProfThread *ProfJoin(void);
+void ProfDump(void);
+unsigned long long ProfClock(void);
+#endif
+
+// Command list  Should be same order as above defines
+// CheckCode() needs a case for each one too
+const char *CODES[NUMCODES] = { "M101", "M102", "M103", "M104", "M108", "M6", "G1", "G92", "M82", "M83", "G90", "G91" };
+
+// Toolhead endings for duplicated commands, one for each of MAXHEADS
+const char *TOOLS[MAXHEADS] = { " T0\012", " T1\012", " T2\012", " T3\012" };
+
+// Extruder used flags, one copy for each thread for --batch
+thread_local int LeftUsed, RightUsed;  // Toolhead used indicators
+thread_local double FirstE;  // First 'E' position from source file
+thread_local int RelativeE;  // 'E's are distances, after an M83 or G91
+thread_local double Ratio[MAXHEADS - 1] = { 1.0, 1.0, 1.0 };  // Ratio of filament areas, for each added toolhead
+thread_local FILE *Msg;  // Where messages go, stderr if the output is stdout
+thread_local ConvStats Stats;  // Counters for --stats
+int NumThreads = 1;  // Threads to convert with, set up for library use too
+int NumHeads = 2;  // Toolheads to extrude from, 2 to MAXHEADS
+size_t OutBufSize = OUTBUFSIZE * 1024 * 1024;  // Output buffer size
+int UseWriteThread;  // Write output on its own thread
+int UseReadThread;  // Read input on its own thread, not mapped
+int UseArena;  // Convert blocks of parsed commands
+int Analyze;  // Add up the moves and filament, without converting
+int Stream;  // Convert and write each line as it comes
+int StreamTool;  // --tool used for --stream, 0 for T0, 1 for T1, -1 if not given
+int UseCkpt;  // Save checkpoints in outfile.ckpt
+int Resume;  // Carry on from outfile.ckpt
+int UseIndex;  // Save a layer index in outfile.idx
+int FromLayer;  // Convert again from this layer of outfile.idx, 0 for all of it
+int BinOut;  // Write the binary format
+int ShowStats;  // Show --stats json
+int Verify;  // Check the output after converting
+int QuickCheck;  // Check up to the first toolhead command, the rest while converting
+const char *CacheDir;  // Where --cache keeps converted files, NULL if not caching
+std::mutex MsgLock;  // Keeps batch messages together
+volatile long BenchSink;  // Keeps the compiler from dropping benchmark work
+ScanFunc ScanBlock = PickScan();  // Best block scanner for this CPU
+#ifdef DUALEXTRUDE_PROFILE
+const char *PROFNAMES[PROFSTAGES] = { "read", "classify", "e_rewrite", "format", "write" };
+thread_local ProfThread *ProfSelf;  // This thread's times, NULL until it starts one
+ProfThread *ProfList;  // Every thread's times
+std::mutex ProfLock;  // Keeps ProfList together
+#endif
+
+
+#ifndef DUALEXTRUDE_NO_MAIN  // Not when used as a library
+
+// Main() function
+// Input:  Command line args
+// Output: Success/Failure code
+int main(int argc, char* argv[])
+{
+	int InfileArg, OutFileArg;
+	int SinglePass = 0;  // Convert without checking the file first
+	char *BadOpt = NULL;  // Option we don't know
+	char *BatchFile = NULL;  // List of files to convert
+	char *BenchSpec = NULL;  // Benchmark settings
+	char *Expect = NULL;  // What the output should be
+	int cnt, NumArgs;
+	int Ok;
+
+	// Clear varibles
+	LeftUsed = 0;
+	RightUsed = 0;
+	FirstE = 0;
+	RelativeE = 0;
+	for (cnt = 0; cnt < MAXHEADS - 1; ++cnt)
+		Ratio[cnt] = 1.0;
+	Msg = stdout;
+	NumThreads = 1;
+	NumHeads = 2;
+	OutBufSize = OUTBUFSIZE * 1024 * 1024;
+	UseWriteThread = 0;
+	UseReadThread = 0;
+	UseArena = 0;
+	Analyze = 0;
+	Stream = 0;
+	StreamTool = -1;
+	UseCkpt = 0;
+	Resume = 0;
+	UseIndex = 0;
+	FromLayer = 0;
+	BinOut = 0;
+	ShowStats = 0;
+	QuickCheck = 0;
+	Verify = 0;
+	CacheDir = NULL;
+
+	// Pull out options, leaving the file/diameter args in argv
+	for (NumArgs = cnt = 1; cnt < argc; ++cnt)
+	{
+		if (!strcmp(argv[cnt],"--single-pass"))
+			SinglePass = 1;
+		else if (!strcmp(argv[cnt],"--quick-check"))
+			QuickCheck = 1;
+		else if (!strcmp(argv[cnt],"--verify"))
+			Verify = 1;
+		else if (!strcmp(argv[cnt],"--threads") && cnt + 1 < argc)
+		{
+			NumThreads = atoi(argv[++cnt]);
+			if (NumThreads < 1 || NumThreads > MAXTHREADS)
+				BadOpt = argv[cnt - 1];
+		}
+		else if (!strcmp(argv[cnt],"--heads") && cnt + 1 < argc)
+		{
+			NumHeads = atoi(argv[++cnt]);
+			if (NumHeads < 2 || NumHeads > MAXHEADS)
+				BadOpt = argv[cnt - 1];
+		}
+		else if (!strcmp(argv[cnt],"--outbuf") && cnt + 1 < argc)
+		{
+			OutBufSize = (size_t) atoi(argv[++cnt]);
+			if (OutBufSize < 1 || OutBufSize > MAXOUTBUF)
+				BadOpt = argv[cnt - 1];
+			OutBufSize *= 1024 * 1024;
+		}
+		else if (!strcmp(argv[cnt],"--write-thread"))
+			UseWriteThread = 1;
+		else if (!strcmp(argv[cnt],"--read-thread"))
+			UseReadThread = 1;
+		else if (!strcmp(argv[cnt],"--arena"))
+			UseArena = 1;
+		else if (!strcmp(argv[cnt],"--analyze"))
+			Analyze = 1;
+		else if (!strcmp(argv[cnt],"--stream"))
+			Stream = 1;
+		else if (!strcmp(argv[cnt],"--tool") && cnt + 1 < argc)
+		{
+			++cnt;
+			if (!strcmp(argv[cnt],"T0") || !strcmp(argv[cnt],"t0"))
+				StreamTool = 0;
+			else if (!strcmp(argv[cnt],"T1") || !strcmp(argv[cnt],"t1"))
+				StreamTool = 1;
+			else
+				BadOpt = argv[cnt - 1];
+		}
+		else if (!strcmp(argv[cnt],"--stats") && cnt + 1 < argc)
+		{
+			if (strcmp(argv[++cnt],"json"))  // Only one kind so far
+				BadOpt = argv[cnt - 1];
+			ShowStats = 1;
+		}
+		else if (!strcmp(argv[cnt],"--binary"))
+			BinOut = 1;
+		else if (!strcmp(argv[cnt],"--checkpoint"))
+			UseCkpt = 1;
+		else if (!strcmp(argv[cnt],"--resume"))
+			UseCkpt = Resume = 1;
+		else if (!strcmp(argv[cnt],"--index"))
+			UseIndex = 1;
+		else if (!strcmp(argv[cnt],"--from-layer") && cnt + 1 < argc)
+		{
+			FromLayer = atoi(argv[++cnt]);
+			if (FromLayer < 1)
+				BadOpt = argv[cnt - 1];
+			UseIndex = 1;
+		}
+		else if (!strcmp(argv[cnt],"--cache") && cnt + 1 < argc)
+			CacheDir = argv[++cnt];
+		else if (!strcmp(argv[cnt],"--batch") && cnt + 1 < argc)
+			BatchFile = argv[++cnt];
+		else if (!strcmp(argv[cnt],"--bench") && cnt + 1 < argc)
+			BenchSpec = argv[++cnt];
+		else if (!strcmp(argv[cnt],"--expect") && cnt + 1 < argc)
+			Expect = argv[++cnt];
+		else if (!strncmp(argv[cnt],"--",2))
+			BadOpt = argv[cnt];
+		else
+			argv[NumArgs++] = argv[cnt];
+	}
+	argc = NumArgs;
+
+	// Keep messages out of the converted file when it goes to stdout
+	if ((3 == argc && !strcmp(argv[2],"-")) || (5 == argc && !strcmp(argv[3],"-")))
+		Msg = stderr;
+
+	fprintf(Msg,"DualExtrude version " VERSION "\n\n");
+
+	if (NULL != BadOpt)
+	{
+		fprintf(Msg,"ERROR: Unknown/bad option: %s\n\n",BadOpt);
+		return (0);
+	}
+
+	// Benchmark, no files needed
+	if (NULL != BenchSpec && 1 == argc)
+	{
+		if (!RunBench(BenchSpec))
+			return (-1);
+
+		return (0);
+	}
+
+	// Analysis, just the input file and maybe the diameters
+	if (Analyze && NULL == BatchFile && NULL == BenchSpec && (2 == argc || 4 == argc))
+	{
+		if (4 == argc && !GetRatio(argv[2],argv[3]))
+			return (-1);
+
+		Stats.Start = GetTime();
+		Ok = AnalyzeFile(argv[1]);
+		if (ShowStats)
+			PrintStats(argv[1],NULL,Ok);
+
+		return (Ok ? 0 : -1);
+	}
+
+	// Batch mode, the files come from the list
+	if (NULL != BatchFile && 1 == argc)
+	{
+		if (NULL != Expect)
+		{
+			fprintf(Msg,"ERROR: --expect is for one file, not --batch\n\n");
+			return (-1);
+		}
+		if (Analyze)
+		{
+			fprintf(Msg,"ERROR: --analyze is for one file, not --batch\n\n");
+			return (-1);
+		}
+
+		if (!RunBatch(BatchFile,SinglePass))
+			return (-1);
+
+		return (0);
+	}
+
+	// Check args
+	switch (NULL != BatchFile || NULL != BenchSpec || Analyze ? 0 : argc) {
+	case 3:  // Just file names
+		InfileArg = 1;  //  Set file name args
+		OutFileArg = 2;
+		break;
+	case 5:  // Also using diameters
+		InfileArg = 1;  // Set file name args
+		OutFileArg = 3;
+
+		// Get diameter ratio
+		if (!GetRatio(argv[2],argv[4]))
+			return (0);
+		break;
+	default:   // Show usage
+		fprintf(Msg,"Usage:  DualExtrude [options] infile [DiaIn] outfile [DiaNew]\n");
+		fprintf(Msg,"        DualExtrude [options] --batch listfile\n");
+		fprintf(Msg,"        DualExtrude --analyze [options] infile [DiaIn DiaNew]\n");
+		fprintf(Msg,"        DualExtrude --bench SPEC\n\n");
+		fprintf(Msg,"          infile - Input single extruder gcode file, - for stdin\n");
+		fprintf(Msg,"          DiaIn - Diameter of filament used to generate the input file.\n");
+		fprintf(Msg,"          outfile - Output both extruder gcode file, - for stdout\n");
+		fprintf(Msg,"          DiaNew - Diameter of filament used on the second extruder. With\n");
+		fprintf(Msg,"                   --heads, one for all the added ones, or a list\n");
+		fprintf(Msg,"                   like \"1.75,2.0\" with one for each in T order.\n\n");
+		fprintf(Msg,"  Options:\n");
+		fprintf(Msg,"          --single-pass - Read the input file once, without checking it first.\n");
+		fprintf(Msg,"          --quick-check - Only check up to the first toolhead command, the\n");
+		fprintf(Msg,"                          rest is checked while converting.\n");
+		fprintf(Msg,"          --verify - Read the output back and check it against the\n");
+		fprintf(Msg,"                     input, on --threads N threads.\n");
+		fprintf(Msg,"          --expect FILE - Compare the output with FILE, and fail if\n");
+		fprintf(Msg,"                          they're not the same.\n");
+		fprintf(Msg,"          --heads N - Extrude from N toolheads (2-%d), T2 and T3 get the\n",MAXHEADS);
+		fprintf(Msg,"                      'C' and 'D' axes.\n");
+		fprintf(Msg,"          --threads N - Convert on N threads (1-%d), not with --single-pass.\n",MAXTHREADS);
+		fprintf(Msg,"                        With --batch, convert N files at once.\n");
+		fprintf(Msg,"          --outbuf MB - Output buffer size (1-%d, default %d).\n",MAXOUTBUF,OUTBUFSIZE);
+		fprintf(Msg,"                        --write-thread and compressed output keep %d\n",RINGSLOTS);
+		fprintf(Msg,"                        buffers that size.\n");
+		fprintf(Msg,"          --write-thread - Write the output on its own thread.\n");
+		fprintf(Msg,"          --read-thread - Read the input on its own thread instead of\n");
+		fprintf(Msg,"                          mapping it, for slow or network storage.\n");
+		fprintf(Msg,"                          --threads needs it mapped.\n");
+		fprintf(Msg,"          --analyze - Show the travel, a time estimate and the filament\n");
+		fprintf(Msg,"                      for each toolhead, without writing a file.\n");
+		fprintf(Msg,"          --arena - Parse blocks of lines into commands and convert\n");
+		fprintf(Msg,"                    those, on one thread.\n");
+		fprintf(Msg,"          --stream - Convert and write each line as soon as it's read,\n");
+		fprintf(Msg,"                     for sending to the printer while converting.\n");
+		fprintf(Msg,"                     Shows the line latency percentiles at the end.\n");
+		fprintf(Msg,"          --tool T0|T1 - Toolhead the input file uses, for --stream.\n");
+		fprintf(Msg,"          --stats json - Show times, byte/line counts and memory use\n");
+		fprintf(Msg,"                         for each file on one line of JSON.\n");
+		fprintf(Msg,"          --binary - Write the binary toolpath format instead of text.\n");
+		fprintf(Msg,"          --checkpoint - Save progress in outfile.ckpt every %d MB.\n",CKPTSIZE / (1024 * 1024));
+		fprintf(Msg,"          --resume - Carry on from outfile.ckpt, or from the end of the\n");
+		fprintf(Msg,"                     last run if the input file has grown since.\n");
+		fprintf(Msg,"          --index - Save where each layer starts in outfile.idx, with the\n");
+		fprintf(Msg,"                    input/output offsets and the 'E' state there.\n");
+		fprintf(Msg,"          --from-layer N - Convert again from layer N of outfile.idx,\n");
+		fprintf(Msg,"                           keeping the output before it. The added\n");
+		fprintf(Msg,"                           extruder diameters can be different.\n");
+		fprintf(Msg,"          --cache DIR - Keep converted files in DIR, and link the one\n");
+		fprintf(Msg,"                        made the same way from there the next time.\n");
+		fprintf(Msg,"          --batch listfile - Convert each \"infile [DiaIn] outfile\n");
+		fprintf(Msg,"                             [DiaNew]\" line of listfile.\n");
+		fprintf(Msg,"          --bench SPEC - Time the conversion on a made up file. SPEC is\n");
+		fprintf(Msg,"                         \"default\" or a list like \"size=64,g1=85,m101=3,\n");
+		fprintf(Msg,"                         m104=1,m108=1,e=90\", size in MB, the others\n");
+		fprintf(Msg,"                         percent of lines, e percent of G1s with an E,\n");
+		fprintf(Msg,"                         min the slowest convert MB/s that passes.\n");
+		fprintf(Msg,"                         \"default,min=50\" changes only min.\n\n");
+		fprintf(Msg,"    NOTE: If you are using different diameter filaments,\n");
+		fprintf(Msg,"          BOTH DiaIn and DiaNew must be given!\n\n");
+		return (0);
+		break;
+	}
+
+	// Check and convert the file
+	Stats.Start = GetTime();
+	if (5 == argc)
+		Ok = DoConv(argv[InfileArg],argv[OutFileArg],argv[2],argv[4],SinglePass);
+	else
+		Ok = DoConv(argv[InfileArg],argv[OutFileArg],NULL,NULL,SinglePass);
+
+	// Check it against what it should be
+	if (Ok && NULL != Expect)
+		Ok = CompareOut(argv[OutFileArg],Expect);
+
+	if (ShowStats)
+		PrintStats(argv[InfileArg],argv[OutFileArg],Ok);
+
+	if (!Ok)
+		return (-1);
+
+	return (0);
+}
+
+#endif
+
+// GetRatio() Function
+//   Checks the filament diameters and sets
+//   Ratio from them.
+//
+// Inputs: DiaIn - Diameter used for the input file
+//         DiaNew - Diameter used on the added extruders, or
+//                  a "D,D,..." list with one for each of them
+//
+// Outputs: Sucess/Failure
+//
+int GetRatio(const char *DiaIn, const char *DiaNew)
+{
+	double D1, D2;  // Filament diameters
+	const char *p;  // Next diameter in DiaNew
+	int Count = 1;  // Diameters in DiaNew
+	int n;
+
+	D1 = 0;
+	sscanf(DiaIn,"%lf",&D1);  // Get first diameter
+	if (D1 < 1.5 || D1 > 2.2) {
+		fprintf(Msg,"ERROR: Filament diameter: %s too big/small!\n\n",DiaIn);
+		return (0);
+	}
+
+	for (p = DiaNew; NULL != (p = strchr(p,',')); ++p)
+		++Count;
+	if (Count != 1 && Count != NumHeads - 1)
+	{
+		fprintf(Msg,"ERROR: Need 1 or %d added extruder diameters: %s\n\n",NumHeads - 1,DiaNew);
+		return (0);
+	}
+
+	// Get the diameter for each added toolhead
+	for (p = DiaNew, n = 0; n < NumHeads - 1; ++n)
+	{
+		D2 = 0;
+		sscanf(p,"%lf",&D2);
+		if (D2 < 1.5 || D2 > 2.2) {
+			fprintf(Msg,"ERROR: Filament diameter: %s too big/small!\n\n",DiaNew);
+			return (0);
+		}
+
+		// Calculate the ratio of the squares of the radius'
+		Ratio[n] = ((D1 / 2) * (D1 / 2)) / ((D2 / 2) * (D2 / 2));
+
+		if (Count > 1)
+			p = strchr(p,',') + 1;
+	}
+
+	return (1);
+}
+
+// DoConv() Function
+//   Checks and converts one file,
+//   the way the command line asked for.
+//
+// Inputs: infile - File to convert
+//         outfile - Name for converted file
+//         DiaIn/DiaNew - Diameters to show, NULL if not given
+//         SinglePass - Check while converting
+//
+// Outputs: Sucess/Failure
+//
+int DoConv(char *infile, char *outfile, const char *DiaIn, const char *DiaNew, int SinglePass)
+{
+	ConvCkpt Ckpt;  // Where the last run got to
+	int Found = 0;  // Resuming from Ckpt
+	InHash Hash;  // Input file hash for --cache
+	char *CacheName = NULL;  // Where the converted file is kept
+	double Start;  // For --stats
+	int Ok;
+
+	// Streamed lines are gone once they're written, and
+	// the toolhead has to be known before the first one
+	if (Stream)
+	{
+		if (StreamTool < 0)
+		{
+			fprintf(Msg,"ERROR: --stream needs --tool T0 or T1\n\n");
+			return (0);
+		}
+		if (UseCkpt || UseIndex || Verify || NULL != CacheDir || BinOut || ZIP_NONE != OutZip(outfile))
+		{
+			fprintf(Msg,"ERROR: --stream can't be used with --checkpoint, --index, --verify, --cache,\n");
+			fprintf(Msg,"       --binary or a compressed output file\n\n");
+			return (0);
+		}
+	}
+	else if (StreamTool >= 0)
+	{
+		fprintf(Msg,"ERROR: --tool is only used with --stream\n\n");
+		return (0);
+	}
+
+	// Checkpoints need offsets that stay put in both files
+	if (UseCkpt)
+	{
+		if (SinglePass || !strcmp(infile,"-") || !strcmp(outfile,"-"))
+		{
+			fprintf(Msg,"ERROR: --checkpoint/--resume need file names and the two pass mode\n\n");
+			return (0);
+		}
+		if (ZIP_NONE != OutZip(outfile))
+		{
+			fprintf(Msg,"ERROR: Can't checkpoint a compressed output file: %s\n\n",outfile);
+			return (0);
+		}
+		if (BinOut)
+		{  // The string table isn't saved
+			fprintf(Msg,"ERROR: Can't checkpoint a --binary output file\n\n");
+			return (0);
+		}
+	}
+
+	// Layer offsets need to be in the files as they are on disk
+	if (UseIndex)
+	{
+		if (SinglePass || !strcmp(infile,"-") || !strcmp(outfile,"-"))
+		{
+			fprintf(Msg,"ERROR: --index/--from-layer need file names and the two pass mode\n\n");
+			return (0);
+		}
+		if (BinOut || ZIP_NONE != OutZip(outfile))
+		{
+			fprintf(Msg,"ERROR: Can't index a --binary or compressed output file\n\n");
+			return (0);
+		}
+	}
+	if (FromLayer && (Resume || Verify))
+	{  // The output has the old ratio before the layer
+		fprintf(Msg,"ERROR: --from-layer can't be used with --resume or --verify\n\n");
+		return (0);
+	}
+
+	// The whole input is hashed by the check before converting
+	if (NULL != CacheDir)
+	{
+#ifdef _WIN32
+		fprintf(Msg,"ERROR: --cache isn't supported on Windows\n\n");
+		return (0);
+#endif
+		if (SinglePass || UseCkpt || UseIndex || !strcmp(infile,"-") || !strcmp(outfile,"-"))
+		{
+			fprintf(Msg,"ERROR: --cache needs file names and the two pass mode, not --checkpoint or --index\n\n");
+			return (0);
+		}
+	}
+
+	// Blocks of commands are converted on their own, from the top
+	if (UseArena && (SinglePass || Stream || UseCkpt || UseIndex || BinOut || !strcmp(infile,"-")))
+	{
+		fprintf(Msg,"ERROR: --arena needs a file name and the two pass mode, not --checkpoint,\n");
+		fprintf(Msg,"       --index or --binary\n\n");
+		return (0);
+	}
+
+	// Move records only have room for 'A' and 'B'
+	if (BinOut && NumHeads > 2)
+	{
+		fprintf(Msg,"ERROR: --binary only holds two extruders, not --heads %d\n\n",NumHeads);
+		return (0);
+	}
+
+	// Both files are read again to verify the output
+	if (Verify)
+	{
+		if (!strcmp(infile,"-") || !strcmp(outfile,"-"))
+		{
+			fprintf(Msg,"ERROR: --verify needs file names\n\n");
+			return (0);
+		}
+		if (BinOut || ZIP_NONE != OutZip(outfile))
+		{
+			fprintf(Msg,"ERROR: Can't verify a --binary or compressed output file\n\n");
+			return (0);
+		}
+	}
+
+	// Streaming, each line goes out as it's converted
+	if (Stream)
+	{
+		if (NULL != DiaIn)
+			fprintf(Msg,"Input file diameter: %s   Added extruder diameter: %s\n",DiaIn,DiaNew);
+
+		Start = GetTime();
+		Ok = ConvFileStream(infile,outfile);
+		Stats.ConvTime = GetTime() - Start;
+		return (Ok);
+	}
+
+	// Single pass, check and convert as we go
+	// stdin can only be read once, so it always uses this
+	if (SinglePass || !strcmp(infile,"-"))
+	{
+		if (NULL != DiaIn)
+			fprintf(Msg,"Input file diameter: %s   Added extruder diameter: %s\n",DiaIn,DiaNew);
+
+		Start = GetTime();
+		Ok = ConvFileOnePass(infile,outfile);
+		Stats.ConvTime = GetTime() - Start;
+		if (Ok && Verify)
+		{
+			Start = GetTime();
+			Ok = VerifyFile(infile,outfile);
+			Stats.VerifyTime = GetTime() - Start;
+		}
+		return (Ok);
+	}
+
+	// Pick up where the last run got to
+	if (Resume)
+	{
+		switch (LoadCkpt(outfile,&Ckpt))
+		{
+		case 0:
+			fprintf(Msg,"No checkpoint, starting from the beginning...\n");
+			break;
+		case 1:
+			if (Ckpt.Heads != NumHeads || memcmp(Ckpt.Ratio,Ratio,(NumHeads - 1) * sizeof(double)))
+			{
+				fprintf(Msg,"ERROR: Checkpoint was made with different filament diameters or --heads\n\n");
+				return (0);
+			}
+			LeftUsed = Ckpt.LeftUsed;
+			RightUsed = Ckpt.RightUsed;
+			Found = 1;
+			fprintf(Msg,"Resuming after line %d...\n",Ckpt.Lines);
+			break;
+		default:
+			fprintf(Msg,"ERROR: Bad checkpoint file for: %s\n\n",outfile);
+			return (0);
+		}
+	}
+
+	// Start again from a layer of the last run
+	if (FromLayer)
+	{
+		if (!LayerStart(infile,outfile,&Ckpt))
+			return (0);
+		LeftUsed = Ckpt.LeftUsed;
+		RightUsed = Ckpt.RightUsed;
+		Found = 1;
+		fprintf(Msg,"Converting again from layer %d, after line %d...\n",FromLayer,Ckpt.Lines);
+	}
+
+	// Check/parse input file, only what's left when resuming
+	fprintf(Msg,"Checking file...\n");
+	Start = GetTime();
+	if (NULL != CacheDir)
+		HashStart(&Hash);
+	Ok = CheckFile(infile,Found ? Ckpt.InPos : 0,NULL != CacheDir ? &Hash : NULL);
+	Stats.CheckTime = GetTime() - Start;
+	if (!Ok)
+		return (0);
+	if (NULL != CacheDir && NULL == (CacheName = CacheFile(HashEnd(&Hash),outfile)))
+	{
+		fprintf(Msg,"ERROR: Out of memory\n\n");
+		return (0);
+	}
+
+	if (LeftUsed)
+		fprintf(Msg,"File uses left extruder, adding right...\n");
+	else
+		fprintf(Msg,"File uses right extruder, adding left...\n");
+	if (NumHeads > 2)
+		fprintf(Msg,"Also adding T2%s...\n",NumHeads > 3 ? " and T3" : "");
+
+	if (NULL != DiaIn)
+		fprintf(Msg,"Input file diameter: %s   Added extruder diameter: %s\n",DiaIn,DiaNew);
+
+	// Generate new file, or use the one from the last time
+	if (Found)
+	{
+		FirstE = Ckpt.FirstE;
+		RelativeE = Ckpt.RelativeE;
+	}
+	Start = GetTime();
+	if (NULL != CacheName && CacheLink(CacheName,outfile))
+	{
+		fprintf(Msg,"Found in the cache: %s\n",CacheName);
+		Stats.Cached = 1;
+		Stats.BytesIn = Hash.Total;
+	}
+	else
+		Ok = ConvFile(infile,outfile,Found ? &Ckpt : NULL);
+	Stats.ConvTime = GetTime() - Start;
+
+	// Check what we made
+	if (Ok && Verify)
+	{
+		Start = GetTime();
+		Ok = VerifyFile(infile,outfile);
+		Stats.VerifyTime = GetTime() - Start;
+	}
+
+	// Keep it for the next time
+	if (Ok && NULL != CacheName && !Stats.Cached)
+	{
+#ifndef _WIN32
+		mkdir(CacheDir,0777);  // Might not be there yet
+#endif
+		if (!CacheLink(outfile,CacheName))
+			fprintf(Msg,"Couldn't save it in the cache: %s\n",CacheName);
+	}
+	free(CacheName);
+
+	return (Ok);
+}
+
+// RunBatch() Function
+//   Converts each file in a list file,
+//   NumThreads at a time.
+//
+// Inputs: listfile - File with one "infile [DiaIn] outfile [DiaNew]" per line
+//         SinglePass - Check while converting
+//
+// Outputs: Sucess/Failure, fails if any file failed
+//
+int RunBatch(char *listfile, int SinglePass)
+{
+	FILE *in;  // List file
+	char buf[4096];  // List file line
+	char *Args[5];  // Words from the line
+	int NumWords;  // Words in the line
+	BatchJob *Jobs = NULL;  // Files to convert
+	BatchJob *NewJobs;
+	int NumJobs = 0;  // Files in the list
+	int JobsSize = 0;  // Jobs allocated
+	BatchQueue *Queues;  // Job list for each thread
+	std::thread *Workers;  // Batch threads
+	int NumQueues;  // Threads used
+	int cnt = 0;  // Line counter
+	int Done = 0;  // Files converted
+	int Ok = 1;
+	int n;
+
+	// Read the list
+	if ((in = fopen(listfile,"r")) == NULL)
+	{
+		fprintf(Msg,"ERROR: Can't open list file: %s\n\n",listfile);
+		return (0);
+	}
+
+	while (NULL != fgets(buf,sizeof(buf),in))
+	{
+		++cnt;  // Increment line counter
+
+		// Split it up, skip blank lines and comments
+		for (NumWords = 0; NumWords < 5; ++NumWords)
+		{
+			if (NULL == (Args[NumWords] = strtok(NumWords ? NULL : buf," \t\r\012")))
+				break;
+		}
+		if (!NumWords || '#' == Args[0][0])
+			continue;
+
+		if (2 != NumWords && 4 != NumWords)
+		{
+			fprintf(Msg,"ERROR: Bad line %d in list file: %s\n\n",cnt,listfile);
+			Ok = 0;
+			break;
+		}
+
+		if (NumJobs == JobsSize)
+		{
+			JobsSize = JobsSize * 2 + 16;
+			if (NULL == (NewJobs = (BatchJob *) realloc(Jobs,JobsSize * sizeof(BatchJob))))
+			{
+				fprintf(Msg,"ERROR: Out of memory in line %d of list file\n\n",cnt);
+				Ok = 0;
+				break;
+			}
+			Jobs = NewJobs;
+		}
+
+		// Same order as the command line
+		memset(&Jobs[NumJobs],0,sizeof(BatchJob));
+		Jobs[NumJobs].infile = strdup(Args[0]);
+		if (2 == NumWords)
+			Jobs[NumJobs].outfile = strdup(Args[1]);
+		else
+		{
+			Jobs[NumJobs].DiaIn = strdup(Args[1]);
+			Jobs[NumJobs].outfile = strdup(Args[2]);
+			Jobs[NumJobs].DiaNew = strdup(Args[3]);
+		}
+		++NumJobs;
+	}
+	fclose(in);
+
+	if (Ok)
+	{
+		// Deal the jobs out to the threads
+		NumQueues = NumThreads < NumJobs ? NumThreads : NumJobs;
+		Queues = new BatchQueue[NumQueues ? NumQueues : 1];
+		for (n = 0; n < NumQueues; ++n)
+		{
+			Queues[n].Jobs = (int *) malloc(((NumJobs / NumQueues) + 1) * sizeof(int));
+			Queues[n].Head = 0;
+			Queues[n].Tail = 0;
+		}
+		for (n = 0; n < NumJobs; ++n)
+			Queues[n % NumQueues].Jobs[Queues[n % NumQueues].Tail++] = n;
+
+		// Each file is converted on one thread
+		NumThreads = 1;
+
+		Workers = new std::thread[NumQueues ? NumQueues : 1];
+		for (n = 0; n < NumQueues; ++n)
+			Workers[n] = std::thread(BatchThread,Queues,Jobs,NumQueues,n,SinglePass);
+		for (n = 0; n < NumQueues; ++n)
+			Workers[n].join();
+
+		for (n = 0; n < NumQueues; ++n)
+			free(Queues[n].Jobs);
+		delete [] Queues;
+		delete [] Workers;
+
+		for (n = 0; n < NumJobs; ++n)
+			Done += Jobs[n].Ok;
+		fprintf(Msg,"%d of %d files converted\n",Done,NumJobs);
+		if (Done != NumJobs)
+			Ok = 0;
+	}
+
+	// Free the list
+	for (n = 0; n < NumJobs; ++n)
+	{
+		free(Jobs[n].infile);
+		free(Jobs[n].outfile);
+		free(Jobs[n].DiaIn);
+		free(Jobs[n].DiaNew);
+	}
+	free(Jobs);
+
+	return (Ok);
+}
+
+// BatchThread() Function
+//   Converts jobs from this thread's list,
+//   then steals jobs from the other lists
+//   until there are none left.
+//
+//   Messages for each file are collected
+//   and shown together when it's done.
+//
+// Inputs: Queues - Job list for each thread
+//         Jobs - Files to convert
+//         NumQueues - Number of lists
+//         Id - This thread's list
+//         SinglePass - Check while converting
+//
+void BatchThread(BatchQueue *Queues, BatchJob *Jobs, int NumQueues, int Id, int SinglePass)
+{
+	BatchJob *Job;  // Job being converted
+	BatchQueue *Queue;  // List we got it from
+	FILE *Log;  // Messages for this job
+	char buf[1024];  // For copying messages
+	size_t Len;
+	int n;
+
+	for (;;)
+	{
+		// Next job from our list, or the end of someone else's
+		Job = NULL;
+		for (n = 0; n < NumQueues && NULL == Job; ++n)
+		{
+			Queue = &Queues[(Id + n) % NumQueues];
+			std::lock_guard<std::mutex> Guard(Queue->Lock);
+			if (Queue->Head < Queue->Tail)
+			{
+				if (0 == n)
+					Job = &Jobs[Queue->Jobs[Queue->Head++]];
+				else
+					Job = &Jobs[Queue->Jobs[--Queue->Tail]];
+			}
+		}
+		if (NULL == Job)  // All done
+			return;
+
+		// Start clean for each file
+		LeftUsed = 0;
+		RightUsed = 0;
+		FirstE = 0;
+		RelativeE = 0;
+		for (n = 0; n < MAXHEADS - 1; ++n)
+			Ratio[n] = 1.0;
+		memset(&Stats,0,sizeof(Stats));
+		Stats.Start = GetTime();
+		Log = tmpfile();
+		Msg = (NULL != Log) ? Log : stdout;
+
+		fprintf(Msg,"%s -> %s\n",Job->infile,Job->outfile);
+		if (NULL != Job->DiaIn)
+			Job->Ok = GetRatio(Job->DiaIn,Job->DiaNew)
+				&& DoConv(Job->infile,Job->outfile,Job->DiaIn,Job->DiaNew,SinglePass);
+		else
+			Job->Ok = DoConv(Job->infile,Job->outfile,NULL,NULL,SinglePass);
+		if (ShowStats)
+			PrintStats(Job->infile,Job->outfile,Job->Ok);
+		fprintf(Msg,"\n");
+
+		// Show the messages for this file together
+		if (NULL != Log)
+		{
+			std::lock_guard<std::mutex> Guard(MsgLock);
+			rewind(Log);
+			while (0 != (Len = fread(buf,1,sizeof(buf),Log)))
+				fwrite(buf,1,Len,stdout);
+			fflush(stdout);
+			fclose(Log);
+		}
+	}
+}
+
+// ConvFile() Function
+//   Reads single extruder input file
+//   and converts it two a "both on" file.
+//
+// Inputs: infile - File to convert
+//         outfile - Name for converted file
+//         From - Checkpoint to carry on from, NULL to start at the top
+//
+// Outputs: Sucess/Failure
+//
+int ConvFile(char *infile, char *outfile, const ConvCkpt *From)
+{
+	InFile in;  // Input file
+	OutFile *out;  // Output file
+	int cnt = 0; // Line counter
+	const char *Line;  // Current input line
+	size_t Len;  // Length of the input line
+	int Lines;  // Lines copied after it
+	int Whole = 1;  // Last line ended with a '\n', so it's safe to checkpoint after
+	char SetLine[64];  // G92 for a changed ratio
+	ConvCkpt At;  // Where a layer starts
+	double Z;  // Its height
+	int n;
+
+	// Open input file
+	if (!OpenIn(&in,infile,UseReadThread ? OPEN_AHEAD : OPEN_MAP))
+	{
+		fprintf(Msg,"ERROR: Can't open input file: %s\n\n",infile);
+		return (0);
+	}
+	if (NULL != From)
+	{
+		if (!SkipIn(&in,From->InPos))
+		{
+			CloseIn(&in);
+			fprintf(Msg,"ERROR: Input file doesn't match the checkpoint/layer index: %s\n\n",infile);
+			return (0);
+		}
+		cnt = From->Lines;
+	}
+
+	// Open output file, keeping what was already converted
+	if ((out = OpenOut(outfile,NULL != From ? From->OutPos : 0)) == NULL)
+	{
+		CloseIn(&in);
+		if (NULL != From)
+			fprintf(Msg,"ERROR: Output file doesn't match the checkpoint/layer index: %s\n\n",outfile);
+		else
+			fprintf(Msg,"ERROR: Can't create output file: %s\n\n",outfile);
+		return (0);
+	}
+	if (UseCkpt)
+	{
+		out->CkptName = CkptFile(outfile);
+		out->CkptIn = in.Base + in.Pos;
+	}
+	if (UseIndex)
+	{
+		out->IdxName = IndexFile(outfile);
+
+		// Keep the layers before where we start, numbered the same
+		if (NULL != From && 1 == LoadIndex(outfile,&out->Layers))
+		{
+			for (n = 0; n < out->Layers.Num && out->Layers.Marks[n].At.InPos < From->InPos; ++n)
+				;
+			out->Layers.Num = n;
+		}
+	}
+
+	// Put the added toolheads where the new ratio has them
+	if (NULL != From && From->SetE)
+	{
+		sprintf(SetLine,"G92 E%.5f\012",From->LastE);
+		if (!PutLine(out,SetLine,strlen(SetLine),0,0))
+		{
+			CloseIn(&in);
+			CloseOut(out);
+			fprintf(Msg,"ERROR: Out of memory\n\n");
+			return (0);
+		}
+	}
+
+	// Parse and convert it a block at a time, that leaves nothing for the loop
+	if (UseArena && !ConvArena(&in,out,&cnt,QuickCheck))
+	{
+		CloseIn(&in);
+		CloseOut(out);
+		if (QuickCheck && strcmp(outfile,"-"))
+			remove(outfile);
+		return (0);
+	}
+
+	// Loop thru file
+	while (ReadLine(&in,&Line,&Len))
+	{
+		++cnt;  // Increment line counter
+
+		// Note where each layer starts, before the line changes anything
+		if (NULL != out->IdxName && MoveZ(Line,Len,&Z))
+		{
+			StateAt(&At,in.Base + in.Pos - Len,out->Queued + out->Len,cnt - 1);
+
+			// The G92 for the new ratio goes with the layer, so the next run redoes it
+			if (NULL != From && From->SetE && At.InPos == From->InPos)
+				At.OutPos = From->OutPos;
+			if (!AddLayer(&out->Layers,Z,&At))
+			{
+				CloseIn(&in);
+				CloseOut(out);
+				fprintf(Msg,"ERROR: Out of memory in line %d\n\n",cnt);
+				return (0);
+			}
+		}
+
+		// Convert and output new/old line, checking it for --quick-check
+		if (!PutLine(out,Line,Len,cnt,QuickCheck))
+		{
+			CloseIn(&in);
+			CloseOut(out);
+			if (QuickCheck && !UseCkpt && strcmp(outfile,"-"))
+				remove(outfile);  // Would have failed the check, don't leave it behind
+			return (0);
+		}
+
+		// Copy the lines after it that don't change
+		if (!BinOut && (Lines = ReadSpan(&in,&Line,&Len,0)))
+		{
+			CopySpan(out,&in,Line,Len);
+			cnt += Lines;
+		}
+
+		// Save where we are now and then, the span may have been empty
+		Whole = ('\012' == in.Data[in.Pos - 1]);
+		if (Whole && !NextCkpt(&in,out,cnt))
+		{
+			CloseIn(&in);
+			CloseOut(out);
+			return (0);
+		}
+
+		// Once we have the first 'E', or 'E's are distances, the rest can be split up
+		if (NumThreads > 1 && in.Mapped && (FirstE > 0 || RelativeE) && !BinOut)
+		{
+			if (!ConvParallel(&in,out,&cnt))
+			{
+				CloseIn(&in);
+				CloseOut(out);
+				if (QuickCheck && !UseCkpt && strcmp(outfile,"-"))
+					remove(outfile);
+				return (0);
+			}
+			Whole = ('\012' == in.Data[in.Size - 1]);
+			break;
+		}
+	}
+
+	// Close flles
+	if (in.Failed)
+	{
+		fprintf(Msg,"ERROR: Can't read input file: %s\n\n",infile);
+		CloseIn(&in);
+		CloseOut(out);
+		return (0);
+	}
+
+	// Leave a checkpoint at the end, so more can be added
+	// to the input file and converted with --resume
+	if ((NULL != out->CkptName && Whole && !SaveCkpt(&in,out,cnt))
+		|| (NULL != out->IdxName && !SaveIndex(out)))
+	{
+		CloseIn(&in);
+		CloseOut(out);
+		return (0);
+	}
+	Stats.BytesIn = in.Base + in.Pos - (NULL != From ? From->InPos : 0);
+	Stats.Lines = cnt;
+	CloseIn(&in);
+	if (!CloseOut(out))
+	{
+		fprintf(Msg,"ERROR: Can't write output file: %s\n\n",outfile);
+		return (0);
+	}
+
+	fprintf(Msg,"%d Lines processed\n",cnt);
+
+	return (1);
+}
+
+// ConvFileOnePass() Function
+//   Same as ConvFile(), but checks the file
+//   while converting it so it is only read once.
+//
+//   Lines are held in memory until a command tells
+//   us which toolhead is active, then everything
+//   after that is converted as it is read.
+//
+// Inputs: infile - File to convert
+//         outfile - Name for converted file
+//
+// Outputs: Sucess/Failure
+//
+int ConvFileOnePass(char *infile, char *outfile)
+{
+	InFile in;  // Input file
+	OutFile *out = NULL;  // Output file, opened once the toolhead is known
+	int cnt = 0; // Line counter
+	const char *Line;  // Current input line
+	size_t Len;  // Length of the input line
+	int Lines;  // Lines copied after it
+	HeldLines Held = { NULL, 0, 0 };  // Lines read before the toolhead is known
+
+	// Open input file
+	if (!OpenIn(&in,infile,UseReadThread ? OPEN_AHEAD : OPEN_MAP))
+	{
+		fprintf(Msg,"ERROR: Can't open input file: %s\n\n",infile);
+		return (0);
+	}
+
+	// Loop thru file
+	while (ReadLine(&in,&Line,&Len))
+	{
+		++cnt;  // Increment line counter
+
+		if (NULL == out)  // Still looking for the used toolhead?
+		{
+			if (!CheckLine(Line,Len))
+			{
+				fprintf(Msg,ERROR_BOTH);
+				goto Fail;
+			}
+
+			if (!RightUsed && !LeftUsed)
+			{  // Not yet, hold this one for later
+				if (!HoldLine(&Held,Line,Len,cnt))
+					goto Fail;
+				continue;
+			}
+
+			if (LeftUsed)
+				fprintf(Msg,"File uses left extruder, adding right...\n");
+			else
+				fprintf(Msg,"File uses right extruder, adding left...\n");
+
+			// Found it, open output file
+			if ((out = OpenOut(outfile,0)) == NULL)
+			{
+				fprintf(Msg,"ERROR: Can't create output file: %s\n\n",outfile);
+				goto Fail;
+			}
+
+			// Output the lines we held, they've already been checked
+			if (!PutHeld(&Held,out))
+				goto Fail;
+
+			// This line has been checked too
+			if (!PutLine(out,Line,Len,cnt,0))
+				goto Fail;
+		}
+		else if (!PutLine(out,Line,Len,cnt,1))  // Convert and check the line
+			goto Fail;
+
+		// Copy the lines after it that don't change, there's nothing in them to check
+		if (!BinOut && (Lines = ReadSpan(&in,&Line,&Len,0)))
+		{
+			CopySpan(out,&in,Line,Len);
+			cnt += Lines;
+		}
+	}
+	if (in.Failed)
+	{
+		fprintf(Msg,"ERROR: Can't read input file: %s\n\n",infile);
+		goto Fail;
+	}
+
+	// Close flles
+	Stats.BytesIn = in.Base + in.Pos;
+	Stats.Lines = cnt;
+	CloseIn(&in);
+	free(Held.Data);
+
+	// Check to see if we found one
+	if (NULL == out)
+	{
+		fprintf(Msg,"ERROR: Couldn't find a used extruder!\n\n");
+		return (0);
+	}
+	if (!CloseOut(out))
+	{
+		fprintf(Msg,"ERROR: Can't write output file: %s\n\n",outfile);
+		if (strcmp(outfile,"-"))
+			remove(outfile);
+		return (0);
+	}
+
+	fprintf(Msg,"%d Lines processed\n",cnt);
+
+	return (1);
+
+Fail:
+	// Close files, and don't leave a partial output file behind
+	CloseIn(&in);
+	free(Held.Data);
+	if (NULL != out)
+	{
+		CloseOut(out);
+		if (strcmp(outfile,"-"))
+			remove(outfile);
+	}
+	return (0);
+}
+
+// ConvFileStream() Function
+//   Converts a file as it arrives, for --stream.
+//   The toolhead comes from --tool, so there's no
+//   check pass and nothing is held. Converted lines
+//   are written before waiting for more input, or
+//   every STREAMLINES lines when more are waiting.
+//
+// Inputs: infile - File to convert
+//         outfile - Name for converted file, can be a device
+//
+// Outputs: Sucess/Failure
+//
+int ConvFileStream(char *infile, char *outfile)
+{
+	InFile in;  // Input file
+	OutFile *out;  // Output file
+	int cnt = 0; // Line counter
+	const char *Line;  // Current input line
+	size_t Len;  // Length of the input line
+	double Read[STREAMLINES];  // When each line waiting to be written was read
+	int Waiting = 0;  // Lines converted but not written
+	LatencyHist *Hist;  // Time from reading each line to writing it
+	double Now;
+	int Ok = 0;
+	int n;
+
+	// The toolhead is known, the rest of the file is checked as it's converted
+	LeftUsed = (1 == StreamTool);
+	RightUsed = (0 == StreamTool);
+	if (LeftUsed)
+		fprintf(Msg,"File uses left extruder, adding right...\n");
+	else
+		fprintf(Msg,"File uses right extruder, adding left...\n");
+
+	if ((Hist = (LatencyHist *) calloc(1,sizeof(LatencyHist))) == NULL)
+	{
+		fprintf(Msg,"ERROR: Out of memory\n\n");
+		return (0);
+	}
+
+	// Open files
+	if (!OpenIn(&in,infile,OPEN_LINES))
+	{
+		fprintf(Msg,"ERROR: Can't open input file: %s\n\n",infile);
+		free(Hist);
+		return (0);
+	}
+	if ((out = OpenOut(outfile,0)) == NULL)
+	{
+		fprintf(Msg,"ERROR: Can't create output file: %s\n\n",outfile);
+		CloseIn(&in);
+		free(Hist);
+		return (0);
+	}
+
+	for (;;)
+	{
+		// Write what's converted before waiting for more
+		if (Waiting && (STREAMLINES == Waiting || !LineReady(&in)))
+		{
+			FlushOut(out);
+			Now = GetTime();
+			for (n = 0; n < Waiting; ++n)
+				AddLatency(Hist,Now - Read[n]);
+			Waiting = 0;
+			if (out->Failed)
+				break;
+		}
+
+		if (!ReadLine(&in,&Line,&Len))
+			break;
+		++cnt;
+		Read[Waiting++] = GetTime();
+
+		// Convert and check the line, the other toolhead can't show up
+		if (!PutLine(out,Line,Len,cnt,1))
+			goto Done;
+	}
+	if (in.Failed)
+	{
+		fprintf(Msg,"ERROR: Can't read input file: %s\n\n",infile);
+		goto Done;
+	}
+	Ok = 1;
+
+Done:
+	// Close files, what was written has already gone to the printer
+	Stats.BytesIn = in.Base + in.Pos;
+	Stats.Lines = cnt;
+	CloseIn(&in);
+	if (!CloseOut(out) && Ok)
+	{
+		fprintf(Msg,"ERROR: Can't write output file: %s\n\n",outfile);
+		Ok = 0;
+	}
+
+	// Show how long lines waited
+	Stats.Streamed = 1;
+	Stats.LatP50 = LatencyAt(Hist,0.5);
+	Stats.LatP90 = LatencyAt(Hist,0.9);
+	Stats.LatP99 = LatencyAt(Hist,0.99);
+	Stats.LatMax = Hist->Max;
+	free(Hist);
+	if (Ok)
+	{
+		fprintf(Msg,"%d Lines processed\n",cnt);
+		fprintf(Msg,"Line latency: p50 %.1f us  p90 %.1f us  p99 %.1f us  max %.1f us\n",
+			Stats.LatP50 * 1e6,Stats.LatP90 * 1e6,Stats.LatP99 * 1e6,Stats.LatMax * 1e6);
+	}
+
+	return (Ok);
+}
+
+// AddLatency() Function
+//   Counts one line's latency.
+//
+// Inputs: Hist - Histogram to add to
+//         Secs - Latency in seconds
+//
+void AddLatency(LatencyHist *Hist, double Secs)
+{
+	unsigned long long Ns = Secs > 0 ? (unsigned long long) (Secs * 1e9) : 0;
+	int Bit;  // Power of 2 bucket
+
+	// Up to 8 ns each get one, then 8 for each power of 2
+	if (Ns < 8)
+		++Hist->Counts[Ns];
+	else
+	{
+		Bit = HighBit(Ns);
+		++Hist->Counts[(Bit - 2) * 8 + (int) ((Ns >> (Bit - 3)) & 7)];
+	}
+	++Hist->Total;
+	if (Secs > Hist->Max)
+		Hist->Max = Secs;
+}
+
+// LatencyAt() Function
+//   Finds a latency percentile.
+//
+// Inputs: Hist - Histogram of latencies
+//         Part - Fraction of lines at or under the result, 0.5 for the median
+//
+// Outputs: Latency in seconds, the top of the bucket it's in
+//
+double LatencyAt(const LatencyHist *Hist, double Part)
+{
+	unsigned long long Want = (unsigned long long) ceil(Part * (double) Hist->Total);
+	unsigned long long Seen = 0;  // Lines in the buckets so far
+	unsigned long long Top;  // Largest ns in the bucket
+	int n;
+
+	if (!Want)
+		Want = 1;
+	for (n = 0; n < LATBUCKETS; ++n)
+	{
+		if ((Seen += Hist->Counts[n]) < Want)
+			continue;
+		if (n < 8)
+			Top = (unsigned long long) n;
+		else
+			Top = ((unsigned long long) (9 + n % 8) << (n / 8 - 1)) - 1;
+		return (Top / 1e9 < Hist->Max ? Top / 1e9 : Hist->Max);
+	}
+
+	return (Hist->Max);  // No lines
+}
+
+// HoldLine() Function
+//   Keeps a line until the used toolhead
+//   is known.
+//
+// Inputs: Held - Lines held so far
+//         Line - Line to hold
+//         Len - Length of the line
+//         cnt - Line number for error messages, 0 to not report errors
+//
+// Outputs: Sucess/Failure
+//
+int HoldLine(HeldLines *Held, const char *Line, size_t Len, int cnt)
+{
+	char *NewData;
+
+	// Each line is stored after its length
+	if (Held->Len + sizeof(size_t) + Len > Held->Size)
+	{
+		Held->Size = (Held->Size + sizeof(size_t) + Len) * 2;
+		if (NULL == (NewData = (char *) realloc(Held->Data,Held->Size)))
+		{
+			if (cnt)
+				fprintf(Msg,"ERROR: Out of memory in line %d\n\n",cnt);
+			return (0);
+		}
+		Held->Data = NewData;
+	}
+	memcpy(Held->Data + Held->Len,&Len,sizeof(size_t));
+	memcpy(Held->Data + Held->Len + sizeof(size_t),Line,Len);
+	Held->Len += sizeof(size_t) + Len;
+
+	return (1);
+}
+
+// PutHeld() Function
+//   Converts the held lines, once the used
+//   toolhead is known, and frees them.
+//
+// Inputs: Held - Lines held, from the first line of the file
+//         out - Output file
+//
+// Outputs: Sucess/Failure
+//
+int PutHeld(HeldLines *Held, OutFile *out)
+{
+	size_t Pos;  // Next held line
+	size_t Len;  // Its length
+	int cnt;  // Its line number
+	int Ok = 1;
+
+	for (Pos = 0, cnt = 1; Ok && Pos < Held->Len; ++cnt)
+	{
+		memcpy(&Len,Held->Data + Pos,sizeof(size_t));
+		Ok = PutLine(out,Held->Data + Pos + sizeof(size_t),Len,cnt,0);  // Already checked
+		Pos += sizeof(size_t) + Len;
+	}
+
+	free(Held->Data);
+	memset(Held,0,sizeof(*Held));
+
+	return (Ok);
+}
+
+// ConvParallel() Function
+//   Converts the rest of a mapped input file
+//   on NumThreads threads.
+//
+//   Each round gives every thread a block of
+//   whole lines, then outputs the blocks in order.
+//   The blocks start with the 'E' state from the
+//   round before. A block after one that changed
+//   it, like an M82 or the first 'E', is done over
+//   here with the right state before it's output.
+//
+// Inputs: in - Mapped input file, at the first line to convert
+//         out - Output file
+//         cnt - Line counter, updated
+//
+// Outputs: Sucess/Failure
+//
+int ConvParallel(InFile *in, OutFile *out, int *cnt)
+{
+	ConvChunk *Chunks;  // Block for each thread
+	std::thread *Workers;  // Conversion threads
+	const char *Next = in->Data + in->Pos;  // Next line to hand out
+	const char *End = in->Data + in->Size;  // End of the file
+	const char *Split;  // End of line after a full block
+	ConvStats Saved;  // Main thread counters, while redoing a block
+	ConvCkpt At;  // Where a layer starts
+	int Used;  // Threads used this round
+	int n, m;
+	int Ok = 1;
+
+	Chunks = (ConvChunk *) calloc(NumThreads,sizeof(ConvChunk));
+	Workers = new std::thread[NumThreads];
+	if (NULL == Chunks)
+	{
+		fprintf(Msg,"ERROR: Out of memory in line %d\n\n",*cnt);
+		delete [] Workers;
+		return (0);
+	}
+
+	while (Ok && Next < End)
+	{
+		// Start a thread on each block
+		for (Used = 0; Used < NumThreads && Next < End; ++Used)
+		{
+			Chunks[Used].Start = Next;
+			if ((size_t) (End - Next) <= CHUNKSIZE)
+				Next = End;
+			else if (NULL != (Split = (const char *) memchr(Next + CHUNKSIZE,'\012',(size_t) (End - Next) - CHUNKSIZE)))
+				Next = Split + 1;
+			else
+				Next = End;
+			Chunks[Used].End = Next;
+			Chunks[Used].FirstLine = 0;
+			Chunks[Used].LeftUsed = LeftUsed;
+			Chunks[Used].RightUsed = RightUsed;
+			Chunks[Used].FirstE = FirstE;
+			Chunks[Used].RelativeE = RelativeE;
+			memcpy(Chunks[Used].Ratio,Ratio,sizeof(Ratio));
+			Chunks[Used].Msg = Msg;
+			Chunks[Used].Index = (NULL != out->IdxName);
+
+			Workers[Used] = std::thread(ConvChunkLines,&Chunks[Used]);
+		}
+
+		for (n = 0; n < Used; ++n)
+			Workers[n].join();
+
+		// Output them in order
+		for (n = 0; n < Used; ++n)
+		{
+			// A block before it changed the 'E' state, do it again with the new one
+			if (Chunks[n].FirstE != FirstE || Chunks[n].RelativeE != RelativeE)
+			{
+				Saved = Stats;
+				memset(&Stats,0,sizeof(Stats));
+				Chunks[n].FirstE = FirstE;
+				Chunks[n].RelativeE = RelativeE;
+				ConvChunkLines(&Chunks[n]);
+				Stats = Saved;
+			}
+
+			if (Chunks[n].Failed)
+			{
+				// Do it again here to report the error with its line number
+				Chunks[n].FirstLine = *cnt + 1;
+				ConvChunkLines(&Chunks[n]);
+				Ok = 0;
+				break;
+			}
+
+			// Layers that start in it, from the start of the file
+			for (m = 0; m < Chunks[n].Zs.Num && Ok; ++m)
+			{
+				At = Chunks[n].Zs.Marks[m].At;
+				At.InPos += in->Base + (unsigned long long) (Chunks[n].Start - in->Data);
+				At.OutPos += out->Queued + out->Len;
+				At.Lines += *cnt;
+				if (!AddLayer(&out->Layers,Chunks[n].Zs.Marks[m].Z,&At))
+				{
+					fprintf(Msg,"ERROR: Out of memory in line %d\n\n",At.Lines + 1);
+					Ok = 0;
+				}
+			}
+			if (!Ok)
+				break;
+
+			PutOut(out,Chunks[n].Out,Chunks[n].OutLen);
+			*cnt += Chunks[n].Lines;
+			AddStats(&Stats,&Chunks[n].Stats);
+			FirstE = Chunks[n].EndFirstE;
+			RelativeE = Chunks[n].EndRelativeE;
+		}
+
+		// Blocks end on whole lines, so this is a good place for a checkpoint
+		in->Pos = (size_t) (Next - in->Data);
+		if (Ok && !NextCkpt(in,out,*cnt))
+			Ok = 0;
+	}
+
+	// Free buffers
+	for (n = 0; n < NumThreads; ++n)
+	{
+		free(Chunks[n].Out);
+		free(Chunks[n].Zs.Marks);
+	}
+	free(Chunks);
+	delete [] Workers;
+
+	return (Ok);
+}
+
+// ConvChunkLines() Function
+//   Converts a block of lines into the
+//   block's output buffer. Run by the
+//   ConvParallel() threads.
+//
+// Inputs: Chunk - Block to convert
+//
+void ConvChunkLines(ConvChunk *Chunk)
+{
+	InFile in;  // Block, read like a mapped file
+	const char *Line;  // Current input line
+	size_t Len;  // Length of the input line
+	size_t OutLen;  // Length of the converted line
+	size_t Room;  // Room needed for it
+	char *NewOut;
+	double OldE;  // To start a line over
+	ConvCkpt At;  // Where a layer starts
+	double Z;  // Its height
+	int Lines;  // Lines copied after it
+	int Ret;
+
+	// Pick up the state, this thread has its own copy
+	LeftUsed = Chunk->LeftUsed;
+	RightUsed = Chunk->RightUsed;
+	FirstE = Chunk->FirstE;
+	RelativeE = Chunk->RelativeE;
+	memcpy(Ratio,Chunk->Ratio,sizeof(Ratio));
+	Msg = Chunk->Msg;
+
+	memset(&in,0,sizeof(in));
+	in.Data = (char *) Chunk->Start;
+	in.Size = (size_t) (Chunk->End - Chunk->Start);
+
+	Chunk->OutLen = 0;
+	Chunk->Lines = 0;
+	Chunk->Failed = 0;
+	Chunk->Zs.Num = 0;
+
+	while (ReadLine(&in,&Line,&Len))
+	{
+		++Chunk->Lines;
+
+		// Note where each layer starts, ConvParallel() adds where the block is
+		if (Chunk->Index && MoveZ(Line,Len,&Z))
+		{
+			StateAt(&At,(unsigned long long) (Line - Chunk->Start),Chunk->OutLen,Chunk->Lines - 1);
+			if (!AddLayer(&Chunk->Zs,Z,&At))
+			{
+				if (Chunk->FirstLine)
+					fprintf(Msg,"ERROR: Out of memory in line %d\n\n",Chunk->FirstLine + Chunk->Lines - 1);
+				Chunk->Failed = 1;
+				return;
+			}
+		}
+
+		// Convert it, with more room if it didn't fit
+		OldE = FirstE;
+		for (Room = Len + MAXOUT;; Room = (Chunk->OutSize - Chunk->OutLen) * 2)
+		{
+			FirstE = OldE;
+			if (Chunk->OutSize - Chunk->OutLen < Room)
+			{
+				Chunk->OutSize = Chunk->OutSize * 2 + CHUNKSIZE + Room;
+				if (NULL == (NewOut = (char *) realloc(Chunk->Out,Chunk->OutSize)))
+				{
+					if (Chunk->FirstLine)
+						fprintf(Msg,"ERROR: Out of memory in line %d\n\n",Chunk->FirstLine + Chunk->Lines - 1);
+					Chunk->Failed = 1;
+					return;
+				}
+				Chunk->Out = NewOut;
+			}
+
+			if ((Ret = ConvLine(Line,Len,Chunk->Out + Chunk->OutLen,Chunk->OutSize - Chunk->OutLen,&OutLen,
+					Chunk->FirstLine ? Chunk->FirstLine + Chunk->Lines - 1 : 0,QuickCheck)) >= 0)
+				break;
+		}
+		if (!Ret)
+		{
+			Chunk->Failed = 1;
+			return;
+		}
+
+		if (!OutLen)  // Unchanged, copy it
+		{
+			memcpy(Chunk->Out + Chunk->OutLen,Line,Len);
+			OutLen = Len;
+		}
+		Chunk->OutLen += OutLen;
+
+		// Copy the lines after it that don't change
+		if ((Lines = ReadSpan(&in,&Line,&Len,0)))
+		{
+			if (Chunk->OutSize - Chunk->OutLen < Len)
+			{
+				Chunk->OutSize = Chunk->OutSize * 2 + CHUNKSIZE + Len;
+				if (NULL == (NewOut = (char *) realloc(Chunk->Out,Chunk->OutSize)))
+				{
+					if (Chunk->FirstLine)
+						fprintf(Msg,"ERROR: Out of memory in line %d\n\n",Chunk->FirstLine + Chunk->Lines);
+					Chunk->Failed = 1;
+					return;
+				}
+				Chunk->Out = NewOut;
+			}
+			memcpy(Chunk->Out + Chunk->OutLen,Line,Len);
+			Chunk->OutLen += Len;
+			Chunk->Lines += Lines;
+		}
+	}
+
+	// Hand back the state and counters, unless this is the main thread reporting an error
+	Chunk->EndFirstE = FirstE;
+	Chunk->EndRelativeE = RelativeE;
+	if (!Chunk->FirstLine)
+		Chunk->Stats = Stats;
+}
+
+// AnalyzeFile() Function
+//   Adds up the moves in a file for --analyze,
+//   without converting it. Mapped files are
+//   done in blocks on NumThreads threads, the
+//   way ConvParallel() does them.
+//
+// Inputs: infile - File to look at
+//
+// Outputs: Sucess/Failure
+//
+int AnalyzeFile(char *infile)
+{
+	InFile in;  // Input file
+	AnaChunk *Chunks;  // Block for each thread
+	std::thread *Workers;  // Threads adding them up
+	const char *Next, *End;  // Next line to hand out, end of the file
+	const char *Split;  // End of line after a full block
+	double Pos[5] = { 0, 0, 0, 0, 0 };  // X/Y/Z/E and feed rate after the blocks so far
+	int RelXYZ = 0, RelE = 0;  // Modes after them
+	int Left = 0, Right = 0;  // Toolheads turned on
+	int Used;  // Blocks this round, then the used toolhead
+	int NumChunks;  // Blocks for each round
+	int cnt = 0;  // Line counter
+	double D[4];  // A deferred move, from the start position
+	double Total = 0;  // mm of filament for the used toolhead
+	double Secs;
+	int n, m, a;
+	int Ok = 1;
+
+	if (!OpenIn(&in,infile,UseReadThread ? OPEN_AHEAD : OPEN_MAP))
+	{
+		fprintf(Msg,"ERROR: Can't open input file: %s\n\n",infile);
+		return (0);
+	}
+
+	// Threads need it all in memory, anything else is one block
+	NumChunks = (NULL == in.fp && NULL == in.Zip) ? NumThreads : 1;
+	Chunks = (AnaChunk *) calloc(NumChunks,sizeof(AnaChunk));
+	Workers = new std::thread[NumChunks];
+	if (NULL == Chunks)
+	{
+		fprintf(Msg,"ERROR: Out of memory\n\n");
+		CloseIn(&in);
+		delete [] Workers;
+		return (0);
+	}
+
+	fprintf(Msg,"Analyzing file...\n");
+	Next = in.Data;
+	End = in.Data + in.Size;
+	do
+	{
+		// Start a thread on each block
+		for (Used = 0; Used < NumChunks && (Next < End || !Used); ++Used)
+		{
+			Chunks[Used].Start = Next;
+			if (1 == NumChunks || (size_t) (End - Next) <= CHUNKSIZE)
+				Next = End;
+			else if (NULL != (Split = (const char *) memchr(Next + CHUNKSIZE,'\012',(size_t) (End - Next) - CHUNKSIZE)))
+				Next = Split + 1;
+			else
+				Next = End;
+			Chunks[Used].End = Next;
+			Chunks[Used].RelXYZ = RelXYZ;
+			Chunks[Used].RelativeE = RelE;
+			if (1 == NumChunks)
+				AnalyzeLines(&Chunks[0],&in);
+			else
+				Workers[Used] = std::thread(AnalyzeChunk,&Chunks[Used]);
+		}
+		for (n = 0; n < Used && NumChunks > 1; ++n)
+			Workers[n].join();
+
+		// Add them up in order
+		for (n = 0; n < Used; ++n)
+		{
+			// A block before it changed the modes, do it again with the new ones
+			if (Chunks[n].RelXYZ != RelXYZ || Chunks[n].RelativeE != RelE)
+			{
+				Chunks[n].RelXYZ = RelXYZ;
+				Chunks[n].RelativeE = RelE;
+				AnalyzeChunk(&Chunks[n]);
+			}
+
+			// Finish the moves that needed the start position
+			for (m = 0; m < Chunks[n].NumDefer; ++m)
+			{
+				for (a = 0; a < 4; ++a)
+					D[a] = Chunks[n].Defer[m].D[a] - ((Chunks[n].Defer[m].Entry >> a) & 1 ? Pos[a] : 0);
+				if ((Chunks[n].Defer[m].Entry >> ANA_F) & 1)
+					AddMove(&Chunks[n],D,Pos[ANA_F],1);
+				else
+					AddMove(&Chunks[n],D,Chunks[n].Defer[m].F,1);
+			}
+			if (Pos[ANA_F] > 0)
+				Chunks[n].Time += Chunks[n].NoFeed * 60.0 / Pos[ANA_F];
+
+			// Carry on from where it ended
+			for (a = 0; a <= ANA_F; ++a)
+				Pos[a] = ((Chunks[n].Known >> a) & 1) ? Chunks[n].Pos[a] : Pos[a] + Chunks[n].Pos[a];
+			RelXYZ = Chunks[n].EndRelXYZ;
+			RelE = Chunks[n].EndRelativeE;
+			Left |= Chunks[n].LeftUsed;
+			Right |= Chunks[n].RightUsed;
+			if (Chunks[n].Both || (Left && Right))
+			{
+				fprintf(Msg,ERROR_BOTH);
+				Ok = 0;
+				break;
+			}
+
+			cnt += Chunks[n].Lines;
+			Stats.Moves += Chunks[n].Moves;
+			Stats.Travel += Chunks[n].Dist;
+			Stats.PrintTime += Chunks[n].Time;
+			Total += Chunks[n].Filament;
+		}
+	} while (Ok && Next < End);
+
+	if (in.Failed)
+	{
+		fprintf(Msg,"ERROR: Can't read input file: %s\n\n",infile);
+		Ok = 0;
+	}
+	Stats.BytesIn = in.Base + in.Pos;
+	Stats.Lines = cnt;
+	CloseIn(&in);
+	free(Chunks);
+	delete [] Workers;
+	if (!Ok)
+		return (0);
+
+	if (!Left && !Right)
+	{
+		fprintf(Msg,"ERROR: Couldn't find a used extruder!\n\n");
+		return (0);
+	}
+	LeftUsed = Left;
+	RightUsed = Right;
+
+	// The added toolheads move the used one's filament times their ratio
+	Used = RightUsed ? 0 : 1;
+	for (n = 0; n < NumHeads - 1; ++n)
+		Stats.Filament[n + (n >= Used)] = Total * Ratio[n];
+	Stats.Filament[Used] = Total;
+	Stats.Analyzed = 1;
+
+	Secs = floor(Stats.PrintTime + 0.5);
+	fprintf(Msg,"%d Lines analyzed, %d moves\n",cnt,Stats.Moves);
+	fprintf(Msg,"  Travel: %.1f mm\n",Stats.Travel);
+	fprintf(Msg,"  Estimated time: %d:%02d:%02d\n",(int) (Secs / 3600),(int) fmod(Secs / 60,60),(int) fmod(Secs,60));
+	for (n = 0; n < NumHeads; ++n)
+		fprintf(Msg,"  Filament T%d: %.1f mm%s\n",n,Stats.Filament[n],n == Used ? " (used in the file)" : "");
+
+	return (1);
+}
+
+// AnalyzeChunk() Function
+//   Adds up a block of a mapped file.
+//   Run by the AnalyzeFile() threads.
+//
+// Inputs: Chunk - Block to add up
+//
+void AnalyzeChunk(AnaChunk *Chunk)
+{
+	InFile in;  // Block, read like a mapped file
+
+	memset(&in,0,sizeof(in));
+	in.Data = (char *) Chunk->Start;
+	in.Size = (size_t) (Chunk->End - Chunk->Start);
+
+	AnalyzeLines(Chunk,&in);
+}
+
+// AnalyzeLines() Function
+//   Adds up the moves from the lines in
+//   a file, the modes start from the Chunk.
+//
+// Inputs: Chunk - Gets the totals
+//         in - Lines to add up
+//
+void AnalyzeLines(AnaChunk *Chunk, InFile *in)
+{
+	GLine Parse;  // Line being parsed
+	GToken Token;  // Next token
+	const char *Line;  // Current input line
+	size_t Len;  // Length of the input line
+	int a;
+
+	// Start from nothing, in case it's being done over
+	Chunk->EndRelXYZ = Chunk->RelXYZ;
+	Chunk->EndRelativeE = Chunk->RelativeE;
+	Chunk->Known = 0;
+	memset(Chunk->Pos,0,sizeof(Chunk->Pos));
+	Chunk->NumDefer = 0;
+	Chunk->Dist = Chunk->Time = Chunk->NoFeed = Chunk->Filament = 0;
+	Chunk->Moves = Chunk->Lines = 0;
+	Chunk->Both = 0;
+	LeftUsed = RightUsed = 0;
+
+	while (ReadLine(in,&Line,&Len))
+	{
+		++Chunk->Lines;
+		StartLine(&Parse,Line,Len);
+		if (NextToken(&Parse,&Token))
+		{
+			switch (CheckCode(&Token))
+			{
+			case M101:  // Can turn on a toolhead
+			case M102:
+			case M104:
+				if (!CheckLine(Line,Len))
+					Chunk->Both = 1;
+				break;
+			case M82:
+				Chunk->EndRelativeE = 0;
+				break;
+			case M83:
+				Chunk->EndRelativeE = 1;
+				break;
+			case G90:  // Positions and 'E' both
+				Chunk->EndRelXYZ = Chunk->EndRelativeE = 0;
+				break;
+			case G91:
+				Chunk->EndRelXYZ = Chunk->EndRelativeE = 1;
+				break;
+			case G92:  // Set position, without moving
+				while (NextToken(&Parse,&Token))
+				{
+					if ('X' == Token.Letter || 'Y' == Token.Letter || 'Z' == Token.Letter)
+						a = Token.Letter - 'X';
+					else if ('E' == Token.Letter || 'A' == Token.Letter || 'B' == Token.Letter)
+						a = 3;
+					else
+						continue;
+					Chunk->Pos[a] = ParseE(Token.Num,Token.NumLen);
+					Chunk->Known |= 1 << a;
+				}
+				break;
+			case G1:
+				AnalyzeMove(Chunk,&Parse);
+				break;
+			}
+		}
+
+		// Skip the lines after it with nothing to add up
+		Chunk->Lines += ReadSpan(in,&Line,&Len,0);
+	}
+
+	Chunk->LeftUsed = LeftUsed;
+	Chunk->RightUsed = RightUsed;
+}
+
+// AnalyzeMove() Function
+//   Adds up one G1, or keeps it for later
+//   if it needs the position before the block.
+//
+// Inputs: Chunk - Block it's in
+//         Parse - Line, after the G1
+//
+void AnalyzeMove(AnaChunk *Chunk, GLine *Parse)
+{
+	GToken Token;  // Next token
+	double New[4];  // Value for each of X/Y/Z/E
+	double D[4] = { 0, 0, 0, 0 };  // Change in each
+	int Given = 0;  // Bit for each one in the line
+	int Entry = 0;  // Bit for each one that needs the start position
+	AnaMove *Move;
+	int a;
+
+	while (NextToken(Parse,&Token))
+	{
+		if ('X' == Token.Letter || 'Y' == Token.Letter || 'Z' == Token.Letter)
+			a = Token.Letter - 'X';
+		else if ('E' == Token.Letter || 'A' == Token.Letter || 'B' == Token.Letter)
+			a = 3;
+		else
+		{
+			if ('F' == Token.Letter)  // Goes with this move too
+			{
+				Chunk->Pos[ANA_F] = ParseE(Token.Num,Token.NumLen);
+				Chunk->Known |= 1 << ANA_F;
+			}
+			continue;
+		}
+		New[a] = ParseE(Token.Num,Token.NumLen);
+		Given |= 1 << a;
+	}
+
+	for (a = 0; a < 4; ++a)
+	{
+		if (!((Given >> a) & 1))
+			continue;
+
+		if (a < 3 ? Chunk->EndRelXYZ : Chunk->EndRelativeE)
+		{  // A distance, the position isn't needed
+			D[a] = New[a];
+			Chunk->Pos[a] += New[a];
+		}
+		else
+		{  // From an offset until the block sets it
+			D[a] = New[a] - Chunk->Pos[a];
+			if (!((Chunk->Known >> a) & 1))
+				Entry |= 1 << a;
+			Chunk->Pos[a] = New[a];
+			Chunk->Known |= 1 << a;
+		}
+	}
+
+	// Each one kept sets another of X/Y/Z/E, so there's room for it
+	if (Entry)
+	{
+		Move = &Chunk->Defer[Chunk->NumDefer++];
+		memcpy(Move->D,D,sizeof(D));
+		Move->Entry = Entry;
+		Move->F = Chunk->Pos[ANA_F];
+		if (!((Chunk->Known >> ANA_F) & 1))
+			Move->Entry |= 1 << ANA_F;
+		return;
+	}
+
+	AddMove(Chunk,D,Chunk->Pos[ANA_F],(Chunk->Known >> ANA_F) & 1);
+}
+
+// AddMove() Function
+//   Adds a move to the totals.
+//
+// Inputs: Chunk - Gets the totals
+//         D - X/Y/Z/E change
+//         F - Feed rate in mm/min, times are 0 if it's not over 0
+//         FKnown - F is known, if not the distance is timed later
+//
+void AddMove(AnaChunk *Chunk, const double *D, double F, int FKnown)
+{
+	double Dist = sqrt((D[0] * D[0]) + (D[1] * D[1]) + (D[2] * D[2]));
+	double Timed = Dist > 0 ? Dist : fabs(D[3]);  // 'E' only moves take time too
+
+	++Chunk->Moves;
+	Chunk->Dist += Dist;
+	Chunk->Filament += D[3];
+	if (!FKnown)
+		Chunk->NoFeed += Timed;
+	else if (F > 0)
+		Chunk->Time += Timed * 60.0 / F;
+}
+
+// CompareOut() Function
+//   Checks that the output is the same
+//   as a file known to be good.
+//
+// Inputs: outfile - Converted file
+//         Expect - What it should be, can be compressed
+//
+// Outputs: Sucess/Failure if they're different
+//
+int CompareOut(const char *outfile, const char *Expect)
+{
+	InFile out, want;  // The two files
+	const char *Line, *WantLine;  // Next line of each
+	size_t Len, WantLen;  // Their lengths
+	int cnt = 0;  // Line counter
+	int Got, WantGot;  // Lines were found
+	int Ok = 0;
+
+	if (!strcmp(outfile,"-"))
+	{
+		fprintf(Msg,"ERROR: --expect needs an output file name\n\n");
+		return (0);
+	}
+	if (!OpenIn(&out,outfile,OPEN_MAP))
+	{
+		fprintf(Msg,"ERROR: Can't open output file: %s\n\n",outfile);
+		return (0);
+	}
+	if (!OpenIn(&want,Expect,OPEN_MAP))
+	{
+		fprintf(Msg,"ERROR: Can't open expected file: %s\n\n",Expect);
+		CloseIn(&out);
+		return (0);
+	}
+
+	for (;;)
+	{
+		Got = ReadLine(&out,&Line,&Len);
+		WantGot = ReadLine(&want,&WantLine,&WantLen);
+		if (!Got || !WantGot)
+			break;
+		++cnt;
+		if (Len != WantLen || memcmp(Line,WantLine,Len))
+		{
+			fprintf(Msg,"ERROR: Output is different from %s in line %d\n\n",Expect,cnt);
+			goto Done;
+		}
+	}
+
+	if (out.Failed || want.Failed)
+		fprintf(Msg,"ERROR: Can't read %s\n\n",out.Failed ? outfile : Expect);
+	else if (Got || WantGot)
+		fprintf(Msg,"ERROR: Output is %s than %s, after line %d\n\n",Got ? "longer" : "shorter",Expect,cnt);
+	else
+	{
+		fprintf(Msg,"Output is the same as %s\n",Expect);
+		Ok = 1;
+	}
+
+Done:
+	CloseIn(&out);
+	CloseIn(&want);
+	return (Ok);
+}
+
+// VerifyFile() Function
+//   Reads a converted file back and checks it
+//   against the input, for --verify. Moves must
+//   keep all their words, with each 'E' made into
+//   an 'A' and a 'B' that match the filament ratio,
+//   and every other line must come out the way
+//   ConvLine() is meant to make it.
+//
+//   Works out where blocks of the two files line
+//   up, then checks the blocks on NumThreads threads.
+//
+// Inputs: infile - File that was converted
+//         outfile - Converted file
+//
+// Outputs: Sucess/Failure
+//
+int VerifyFile(char *infile, char *outfile)
+{
+	InFile in, out;  // Both files, mapped
+	VerifyChunk *Chunks = NULL;  // Blocks to check
+	VerifyChunk *Chunk;
+	VerifyChunk *NewChunks;
+	int NumChunks = 0;
+	int MaxChunks = 0;
+	const char *Line;  // Current input line
+	size_t Len;  // Length of the input line
+	size_t Start;  // Start of the block
+	int cnt = 0;  // Line counter
+	int Lines;  // Lines copied after it
+	int OutLines;  // Output lines for the block
+	int TotalOut = 0;  // Output lines before it
+	double E = 0;  // FirstE at this point
+	int Rel = 0;  // RelativeE at this point
+	std::thread *Workers;  // Checking threads
+	std::atomic<int> Next(0);  // Next block for a thread
+	std::atomic<int> FirstBad;  // First block that didn't match
+	int Used;  // Threads used
+	int n;
+	int Ok = 1;
+
+	memset(&out,0,sizeof(out));
+	if (!OpenIn(&in,infile,OPEN_MAP) || !OpenIn(&out,outfile,OPEN_MAP))
+	{
+		CloseIn(&in);
+		fprintf(Msg,"ERROR: Can't open files to verify: %s, %s\n\n",infile,outfile);
+		return (0);
+	}
+	if (!in.Mapped || !out.Mapped)
+	{
+		CloseIn(&in);
+		CloseIn(&out);
+		fprintf(Msg,"ERROR: Can't verify compressed files\n\n");
+		return (0);
+	}
+
+	// Split the input into blocks, and count the output lines
+	// for each to find where its output starts. The blocks
+	// need the first 'E' from before them too.
+	while (in.Pos < in.Size)
+	{
+		if (NumChunks == MaxChunks)
+		{
+			MaxChunks = MaxChunks * 2 + 16;
+			if (NULL == (NewChunks = (VerifyChunk *) realloc(Chunks,MaxChunks * sizeof(VerifyChunk))))
+			{
+				fprintf(Msg,"ERROR: Out of memory to verify\n\n");
+				Ok = 0;
+				break;
+			}
+			Chunks = NewChunks;
+		}
+		Chunk = &Chunks[NumChunks];
+		Chunk->In = in.Data + in.Pos;
+		Chunk->Out = NumChunks ? Chunks[NumChunks - 1].OutEnd : out.Data;
+		Chunk->FirstLine = cnt + 1;
+		Chunk->OutLine = TotalOut + 1;
+		Chunk->RightUsed = RightUsed;
+		Chunk->FirstE = E;
+		Chunk->RelativeE = Rel;
+		memcpy(Chunk->Ratio,Ratio,sizeof(Ratio));
+		Chunk->Failed = 0;
+		++NumChunks;
+
+		// Whole lines, up to about CHUNKSIZE
+		Start = in.Pos;
+		OutLines = 0;
+		while (in.Pos - Start < CHUNKSIZE && ReadLine(&in,&Line,&Len))
+		{
+			++cnt;
+			OutLines += VerifyCount(Line,Len,&E,&Rel);
+
+			// Lines that are copied make one line each
+			Lines = ReadSpan(&in,&Line,&Len,0);
+			cnt += Lines;
+			OutLines += Lines;
+		}
+		Chunk->InEnd = in.Data + in.Pos;
+		Chunk->OutEnd = SkipLines(Chunk->Out,out.Data + out.Size,OutLines);
+		TotalOut += OutLines;
+	}
+
+	// Anything past the last block doesn't belong
+	if (Ok && !NumChunks && out.Size)
+	{
+		fprintf(Msg,"ERROR: Verify failed, output for an empty input file\n\n");
+		Ok = 0;
+	}
+	if (Ok && NumChunks)
+	{
+		Chunks[NumChunks - 1].OutEnd = out.Data + out.Size;
+
+		// Check the blocks, each thread takes the next one
+		// until they're all done or one doesn't match
+		FirstBad = NumChunks;
+		Used = NumThreads < NumChunks ? NumThreads : NumChunks;
+		Workers = new std::thread[Used];
+		for (n = 1; n < Used; ++n)
+			Workers[n] = std::thread(VerifyThread,Chunks,NumChunks,&Next,&FirstBad);
+		VerifyThread(Chunks,NumChunks,&Next,&FirstBad);
+		for (n = 1; n < Used; ++n)
+			Workers[n].join();
+		delete [] Workers;
+
+		// Report the first difference
+		if (FirstBad < NumChunks)
+		{
+			Chunk = &Chunks[(int) FirstBad];
+			fprintf(Msg,"ERROR: Verify failed at input line %d, output line %d: %s\n\n",
+				Chunk->BadLine,Chunk->BadOut,Chunk->Why);
+			Ok = 0;
+		}
+		else
+			fprintf(Msg,"%d Lines verified\n",cnt);
+	}
+
+	free(Chunks);
+	CloseIn(&in);
+	CloseIn(&out);
+
+	return (Ok);
+}
+
+// VerifyThread() Function
+//   Checks blocks for VerifyFile() until
+//   there are none left.
+//
+// Inputs: Chunks - Blocks to check
+//         NumChunks - Number of blocks
+//         Next - Next block to take
+//         FirstBad - First block that didn't match, lowered as they're found
+//
+void VerifyThread(VerifyChunk *Chunks, int NumChunks, std::atomic<int> *Next, std::atomic<int> *FirstBad)
+{
+	int n;
+	int Bad;
+
+	// Blocks after one that failed don't need checking
+	while ((n = (*Next)++) < NumChunks && n < *FirstBad)
+	{
+		if (VerifyLines(&Chunks[n]))
+			continue;
+
+		Bad = *FirstBad;
+		while (n < Bad && !FirstBad->compare_exchange_weak(Bad,n))
+			;
+	}
+}
+
+// VerifyLines() Function
+//   Checks one block of the converted file
+//   against the input lines it came from.
+//
+// Inputs: Chunk - Block to check, Failed/BadLine/BadOut/Why set
+//                 if it doesn't match
+//
+// Outputs: 1 if it matches
+//
+int VerifyLines(VerifyChunk *Chunk)
+{
+	InFile in, out;  // Both blocks, read like mapped files
+	const char *Line;  // Current input line
+	size_t Len;  // Length of the input line
+	size_t OutPos = 0;  // Where the line's output starts
+	int Lines;  // Lines copied after it
+	int cnt = Chunk->FirstLine - 1;  // Line counter
+	size_t n;
+
+	memset(&in,0,sizeof(in));
+	in.Data = (char *) Chunk->In;
+	in.Size = (size_t) (Chunk->InEnd - Chunk->In);
+	memset(&out,0,sizeof(out));
+	out.Data = (char *) Chunk->Out;
+	out.Size = (size_t) (Chunk->OutEnd - Chunk->Out);
+
+	Chunk->E = Chunk->FirstE;
+
+	while (ReadLine(&in,&Line,&Len))
+	{
+		++cnt;
+		OutPos = out.Pos;
+		if (!VerifyLine(Chunk,Line,Len,&out))
+			break;
+
+		// Lines that don't change have to be the same bytes
+		if ((Lines = ReadSpan(&in,&Line,&Len,0)))
+		{
+			if (out.Size - out.Pos >= Len && !memcmp(Line,out.Data + out.Pos,Len))
+			{
+				out.Pos += Len;
+				cnt += Lines;
+				continue;
+			}
+
+			// Find the line that's different
+			for (n = 0; n < Len && out.Pos + n < out.Size && Line[n] == out.Data[out.Pos + n]; ++n)
+				if ('\012' == Line[n])
+					++cnt;
+			++cnt;
+			for (OutPos = out.Pos + n; OutPos > out.Pos && '\012' != out.Data[OutPos - 1]; --OutPos)
+				;
+			VerifyFail(Chunk,out.Pos + n < out.Size ? "line changed" : "output ends early");
+			break;
+		}
+	}
+
+	if (!Chunk->Failed && out.Pos < out.Size)
+	{
+		VerifyFail(Chunk,"extra output lines");
+		OutPos = out.Pos;
+	}
+
+	if (Chunk->Failed)
+	{
+		// Line numbers for the message
+		Chunk->BadLine = cnt;
+		Chunk->BadOut = Chunk->OutLine + CountLines(out.Data,out.Data + OutPos);
+	}
+
+	return (!Chunk->Failed);
+}
+
+// VerifyLine() Function
+//   Checks the output for one input line.
+//
+// Inputs: Chunk - Block being checked, E updated
+//         Line - Input line
+//         Len - Length of the line
+//         out - Output block, at the line's output
+//
+// Outputs: 1 if it matches
+//
+int VerifyLine(VerifyChunk *Chunk, const char *Line, size_t Len, InFile *out)
+{
+	GLine Parse;  // Line being parsed
+	GToken Token;  // Next token
+	GToken Speed;  // Speed from a speed command
+	const char *NotUsed = Chunk->RightUsed ? "T1" : "T0";  // Toolhead that isn't used
+	char Want[64];  // Line that should be there
+	GLine Rest;  // Rest of a G92
+	int Code;
+	int Temp;
+	int Head;
+	int n;
+
+	StartLine(&Parse,Line,Len);
+	if (NextToken(&Parse,&Token))
+		Code = CheckCode(&Token);
+	else
+		Code = NOTOKENS;
+
+	switch (Code)
+	{
+	case M101:  // On/Off commands, for each toolhead
+	case M102:
+	case M103:
+	case M6:
+		if (NextToken(&Parse,&Token) && TokenIs(&Token,NotUsed))
+			return (VerifyNext(Chunk,out,Line,Len));  // Left as it was for the other one
+		for (Head = NumHeads - 1; Head >= 0; --Head)
+		{
+			n = sprintf(Want,"%s T%d\012",CODES[Code],Head);
+			if (!VerifyNext(Chunk,out,Want,(size_t) n))
+				return (0);
+		}
+		return (1);
+	case M104:  // Temp, for each toolhead
+		Temp = 0;
+		while (NextToken(&Parse,&Token) && !TokenIs(&Token,NotUsed))
+		{
+			if ('S' == Token.Letter)
+				ParseInt(Token.Num,Token.NumLen,&Temp);
+		}
+		for (Head = NumHeads - 1; Head >= 0; --Head)
+		{
+			n = sprintf(Want,"M104 S%d T%d\012",Temp,Head);
+			if (!VerifyNext(Chunk,out,Want,(size_t) n))
+				return (0);
+		}
+		return (1);
+	case M108:  // Speed, for each toolhead
+		Speed.Ptr = Line;
+		Speed.Len = 0;
+		while (NextToken(&Parse,&Token) && !TokenIs(&Token,NotUsed))
+		{
+			if ('R' == Token.Letter)
+				Speed = Token;
+		}
+		if (!Speed.Len || Speed.Len > 15)
+			return (VerifyFail(Chunk,"bad speed command was converted"));
+		for (Head = NumHeads - 1; Head >= 0; --Head)
+		{
+			n = sprintf(Want,"M108 %.*s T%d\012",(int) Speed.Len,Speed.Ptr,Head);
+			if (!VerifyNext(Chunk,out,Want,(size_t) n))
+				return (0);
+		}
+		return (1);
+	case G1:
+		return (VerifyMove(Chunk,&Parse,out,Code));
+	case G92:  // Only changed if it sets 'E'
+		Rest = Parse;
+		while (NextToken(&Rest,&Token))
+		{
+			if ('E' == Token.Letter || 'A' == Token.Letter || 'B' == Token.Letter)
+				return (VerifyMove(Chunk,&Parse,out,Code));
+		}
+		break;
+	case M82:  // 'E' mode, copied
+	case G90:
+		Chunk->RelativeE = 0;
+		break;
+	case M83:
+	case G91:
+		Chunk->RelativeE = 1;
+		break;
+	}
+
+	// Anything else is copied
+	return (VerifyNext(Chunk,out,Line,Len));
+}
+
+// VerifyMove() Function
+//   Checks the output for a G1 move. Each
+//   word has to be the same, apart from the
+//   'E's. The first 'E' becomes an 'A', 'B', ...
+//   for each toolhead with the same value, after
+//   that the added toolheads get the distance from
+//   the first 'E' times their filament ratio. When
+//   'E's are relative a move's 'E' is the distance.
+//   A G92 that sets 'E' is checked the same way.
+//
+// Inputs: Chunk - Block being checked, E updated
+//         Parse - Input line, after the "G1"
+//         out - Output block, at the move
+//         Code - G1 or G92
+//
+// Outputs: 1 if it matches
+//
+int VerifyMove(VerifyChunk *Chunk, GLine *Parse, InFile *out, int Code)
+{
+	GLine OutParse;  // Output line being parsed
+	GToken Token;  // Next input token
+	GToken OutToken;  // Next output token
+	GToken New;  // 'A', 'B', ... for an 'E', added toolheads first
+	const char *Line;
+	size_t Len;
+	double CurrentE;  // 'E' from the input
+	double Expect;  // What an added toolhead should get
+	double Base;  // Where the distances are from
+	int Relative = Chunk->RelativeE && G1 == Code;  // 'E's are distances
+	int Used = Chunk->RightUsed ? 0 : 1;  // Toolhead in the input
+	int Head;
+	int n;
+
+	if (!ReadLine(out,&Line,&Len))
+		return (VerifyFail(Chunk,"output ends early"));
+	StartLine(&OutParse,Line,Len);
+	if (!NextToken(&OutParse,&OutToken) || !TokenIs(&OutToken,CODES[Code]) || '\012' != Line[Len - 1])
+		return (VerifyFail(Chunk,"move is missing"));
+
+	while (NextToken(Parse,&Token))
+	{
+		if ('E' != Token.Letter && 'A' != Token.Letter && 'B' != Token.Letter)
+		{  // Anything else has to be the same, so the path doesn't change
+			if (!NextToken(&OutParse,&OutToken) || OutToken.Len != Token.Len
+					|| memcmp(OutToken.Ptr,Token.Ptr,Token.Len))
+				return (VerifyFail(Chunk,"move changed"));
+			continue;
+		}
+
+		CurrentE = VerifyNum(Token.Num,Token.NumLen);
+
+		if (Chunk->E > 0 || Relative)
+		{
+			// The added toolheads in order, then the used one
+			Base = Relative ? 0 : Chunk->E;
+			for (n = 0, Head = 0; Head < NumHeads; ++Head)
+			{
+				if (Head == Used)
+					continue;
+				if (!NextToken(&OutParse,&New))
+					return (VerifyFail(Chunk,"A/B missing"));
+				if (New.Letter != 'A' + Head)
+					return (VerifyFail(Chunk,"E changed"));
+
+				Expect = ((CurrentE - Base) * Chunk->Ratio[n++]) + Base;
+				if (!(fabs(VerifyNum(New.Num,New.NumLen) - Expect) <= VERIFYTOL + fabs(Expect) * 1e-12))
+					return (VerifyFail(Chunk,"new toolhead doesn't match the filament ratio"));
+			}
+			if (!NextToken(&OutParse,&New))
+				return (VerifyFail(Chunk,"A/B missing"));
+			if (New.Letter != 'A' + Used || New.NumLen != Token.NumLen || memcmp(New.Num,Token.Num,Token.NumLen))
+				return (VerifyFail(Chunk,"E changed"));
+		}
+		else
+		{  // First 'E', they all get it
+			for (Head = 0; Head < NumHeads; ++Head)
+			{
+				if (!NextToken(&OutParse,&New))
+					return (VerifyFail(Chunk,"A/B missing"));
+				if (New.Letter != 'A' + Head || New.NumLen != Token.NumLen || memcmp(New.Num,Token.Num,Token.NumLen))
+					return (VerifyFail(Chunk,"first E changed"));
+			}
+			Chunk->E = CurrentE;
+		}
+	}
+
+	if (NextToken(&OutParse,&OutToken))
+		return (VerifyFail(Chunk,"extra words in move"));
+
+	return (1);
+}
+
+// VerifyNext() Function
+//   Checks that the next output line
+//   is the one we want.
+//
+// Inputs: Chunk - Block being checked
+//         out - Output block
+//         Want - Line that should be next
+//         Len - Length of it
+//
+// Outputs: 1 if it matches
+//
+int VerifyNext(VerifyChunk *Chunk, InFile *out, const char *Want, size_t Len)
+{
+	const char *Line;
+	size_t LineLen;
+
+	if (!ReadLine(out,&Line,&LineLen))
+		return (VerifyFail(Chunk,"output ends early"));
+	if (LineLen != Len || memcmp(Line,Want,Len))
+		return (VerifyFail(Chunk,"line changed"));
+
+	return (1);
+}
+
+// VerifyFail() Function
+//   Notes what was wrong with a block.
+//
+// Inputs: Chunk - Block being checked
+//         Why - What was wrong
+//
+// Outputs: 0, to return
+//
+int VerifyFail(VerifyChunk *Chunk, const char *Why)
+{
+	Chunk->Failed = 1;
+	Chunk->Why = Why;
+	return (0);
+}
+
+// VerifyCount() Function
+//   Works out how many output lines an input
+//   line makes, and keeps track of the first 'E'
+//   and the 'E' mode. Used to line up the blocks
+//   for VerifyFile().
+//
+// Inputs: Line - Input line
+//         Len - Length of the line
+//         E - First 'E' so far, updated
+//         RelativeE - 'E' mode so far, updated
+//
+// Outputs: Output lines
+//
+int VerifyCount(const char *Line, size_t Len, double *E, int *RelativeE)
+{
+	GLine Parse;  // Line being parsed
+	GToken Token;  // Next token
+	int Code;
+
+	StartLine(&Parse,Line,Len);
+	if (!NextToken(&Parse,&Token))
+		return (1);
+
+	switch (Code = CheckCode(&Token))
+	{
+	case M101:  // Left as they are for the other toolhead
+	case M102:
+	case M103:
+	case M6:
+		if (NextToken(&Parse,&Token) && TokenIs(&Token,RightUsed ? "T1" : "T0"))
+			return (1);
+		return (NumHeads);
+	case M104:
+	case M108:
+		return (NumHeads);
+	case M82:
+	case G90:
+		*RelativeE = 0;
+		return (1);
+	case M83:
+	case G91:
+		*RelativeE = 1;
+		return (1);
+	case G1:
+	case G92:
+		// Only the 'E's up to the first one above 0 matter,
+		// relative ones are distances
+		while (*E <= 0 && !(*RelativeE && G1 == Code) && NextToken(&Parse,&Token))
+		{
+			if ('E' == Token.Letter || 'A' == Token.Letter || 'B' == Token.Letter)
+				*E = VerifyNum(Token.Num,Token.NumLen);
+		}
+		return (1);
+	}
+
+	return (1);
+}
+
+// VerifyNum() Function
+//   Reads a number from a word with strtod(),
+//   not the converter's own parser.
+//
+// Inputs: p - Start of the number
+//         Len - Chars available
+//
+// Outputs: The number, 0 if there isn't one
+//
+double VerifyNum(const char *p, size_t Len)
+{
+	char Num[64];
+
+	if (Len >= sizeof(Num))
+		Len = sizeof(Num) - 1;
+	memcpy(Num,p,Len);
+	Num[Len] = 0;
+
+	return (strtod(Num,NULL));
+}
+
+// SkipLines() Function
+//   Finds the start of a later line.
+//
+// Inputs: p - Start of a line
+//         End - End of the data
+//         n - Lines to skip
+//
+// Outputs: Start of the line, End if there aren't enough
+//
+const char *SkipLines(const char *p, const char *End, int n)
+{
+	unsigned long long Ends, Starts, Gs;  // From ScanBlock()
+	int Found;
+
+	// Count the '\n's a block at a time
+	while (n > 0 && End - p >= SCANBLOCK)
+	{
+		ScanBlock(p,&Ends,&Starts,&Gs);
+		if ((Found = CountBits(Ends)) < n)
+		{
+			n -= Found;
+			p += SCANBLOCK;
+			continue;
+		}
+
+		// It's in this block
+		for (; n > 1; --n)
+			Ends &= Ends - 1;
+		return (p + LowBit(Ends) + 1);
+	}
+
+	for (; n > 0 && NULL != (p = (const char *) memchr(p,'\012',(size_t) (End - p))); --n)
+		++p;
+
+	return (NULL == p ? End : p);
+}
+
+// CountLines() Function
+//   Counts the '\n's in some data.
+//
+// Inputs: p - Start of the data
+//         End - End of the data
+//
+// Outputs: Lines
+//
+int CountLines(const char *p, const char *End)
+{
+	int n = 0;
+
+	for (; p < End && NULL != (p = (const char *) memchr(p,'\012',(size_t) (End - p))); ++p)
+		++n;
+
+	return (n);
+}
+
+// CacheFile() Function
+//   Makes the --cache name for a converted file,
+//   from the input's hash and everything else that
+//   changes the output.
+//
+// Inputs: InSum - Hash of the input file
+//         outfile - Output file name, for its compression
+//
+// Outputs: Name to free(), NULL if out of memory
+//
+char *CacheFile(unsigned long long InSum, const char *outfile)
+{
+	InHash Hash;  // Hash of the settings
+	char Settings[256];
+	char *Name;
+	int Len;
+	int n;
+
+	Len = sprintf(Settings,"DualExtrude %s heads %d binary %d zip %d ratio",VERSION,NumHeads,BinOut,OutZip(outfile));
+	for (n = 0; n < NumHeads - 1; ++n)
+		Len += sprintf(Settings + Len," %a",Ratio[n]);
+	HashStart(&Hash);
+	HashAdd(&Hash,Settings,(size_t) Len);
+
+	if (NULL != (Name = (char *) malloc(strlen(CacheDir) + 40)))
+		sprintf(Name,"%s/%016llx-%016llx",CacheDir,InSum,HashEnd(&Hash));
+
+	return (Name);
+}
+
+// CacheLink() Function
+//   Puts a file under another name without
+//   copying it, as a reflink if the file system
+//   has them, or else a hard link. The new name
+//   is replaced all at once.
+//
+// Inputs: From - File to link
+//         To - Name for it
+//
+// Outputs: Sucess/Failure
+//
+int CacheLink(const char *From, const char *To)
+{
+#ifdef _WIN32
+	return (0);
+#else
+	static std::atomic<unsigned> TmpCount(0);  // Keeps batch threads' temp names apart
+	char *Tmp;  // Temp name, until it's complete
+	int In, Out;
+	int Ok = 0;
+
+	if (NULL == (Tmp = (char *) malloc(strlen(To) + 40)))
+		return (0);
+	sprintf(Tmp,"%s.%ld.%u.tmp",To,(long) getpid(),++TmpCount);
+
+#ifdef FICLONE
+	// A reflink shares the blocks until one is changed
+	if ((In = open(From,O_RDONLY)) >= 0)
+	{
+		if ((Out = open(Tmp,O_WRONLY | O_CREAT | O_EXCL,0666)) >= 0)
+		{
+			Ok = !ioctl(Out,FICLONE,In);
+			Ok = !close(Out) && Ok;
+			if (!Ok)
+				unlink(Tmp);
+		}
+		close(In);
+	}
+#endif
+
+	// Both names for the same file
+	if (!Ok)
+		Ok = !link(From,Tmp);
+
+	if (Ok && rename(Tmp,To))
+	{
+		unlink(Tmp);
+		Ok = 0;
+	}
+	free(Tmp);
+
+	return (Ok);
+#endif
+}
+
+// HashStart() / HashAdd() / HashEnd() Functions
+//   XXH64 of the input file, added to as the
+//   check reads it. Any block sizes give the
+//   same hash.
+//
+// Inputs: Hash - Hash being built
+//         Data/Len - Next bytes of the file
+//
+// Outputs: HashEnd() returns the hash
+//
+#define HASH_P1 11400714785074694791ULL
+#define HASH_P2 14029467366897019727ULL
+#define HASH_P3 1609587929392839161ULL
+#define HASH_P4 9650029242287828579ULL
+#define HASH_P5 2870177450012600261ULL
+
+void HashStart(InHash *Hash)
+{
+	Hash->Acc[0] = HASH_P1 + HASH_P2;
+	Hash->Acc[1] = HASH_P2;
+	Hash->Acc[2] = 0;
+	Hash->Acc[3] = 0 - HASH_P1;
+	Hash->BufLen = 0;
+	Hash->Total = 0;
+}
+
+void HashAdd(InHash *Hash, const char *Data, size_t Len)
+{
+	const unsigned char *p = (const unsigned char *) Data;
+	size_t n;
+
+	Hash->Total += Len;
+
+	// Finish the partial stripe first
+	if (Hash->BufLen)
+	{
+		n = 32 - Hash->BufLen;
+		if (n > Len)
+			n = Len;
+		memcpy(Hash->Buf + Hash->BufLen,p,n);
+		Hash->BufLen += n;
+		p += n;
+		Len -= n;
+		if (Hash->BufLen < 32)
+			return;
+		for (n = 0; n < 4; ++n)
+			Hash->Acc[n] = HashRound(Hash->Acc[n],HashGet(Hash->Buf + n * 8));
+		Hash->BufLen = 0;
+	}
+
+	for (; Len >= 32; p += 32, Len -= 32)
+	{
+		Hash->Acc[0] = HashRound(Hash->Acc[0],HashGet(p));
+		Hash->Acc[1] = HashRound(Hash->Acc[1],HashGet(p + 8));
+		Hash->Acc[2] = HashRound(Hash->Acc[2],HashGet(p + 16));
+		Hash->Acc[3] = HashRound(Hash->Acc[3],HashGet(p + 24));
+	}
+
+	memcpy(Hash->Buf,p,Len);
+	Hash->BufLen = Len;
+}
+
+unsigned long long HashEnd(InHash *Hash)
+{
+	unsigned long long h;
+	const unsigned char *p = Hash->Buf;
+	size_t Len = Hash->BufLen;
+	int n;
+
+	if (Hash->Total >= 32)
+	{
+		h = HashRot(Hash->Acc[0],1) + HashRot(Hash->Acc[1],7) + HashRot(Hash->Acc[2],12) + HashRot(Hash->Acc[3],18);
+		for (n = 0; n < 4; ++n)
+			h = ((h ^ HashRound(0,Hash->Acc[n])) * HASH_P1) + HASH_P4;
+	}
+	else
+		h = HASH_P5;
+	h += Hash->Total;
+
+	// The bytes past the last stripe
+	for (; Len >= 8; p += 8, Len -= 8)
+		h = (HashRot(h ^ HashRound(0,HashGet(p)),27) * HASH_P1) + HASH_P4;
+	if (Len >= 4)
+	{
+		h = (HashRot(h ^ (((unsigned long long) p[0] | (p[1] << 8) | (p[2] << 16) | ((unsigned long long) p[3] << 24)) * HASH_P1),23)
+			* HASH_P2) + HASH_P3;
+		p += 4;
+		Len -= 4;
+	}
+	for (; Len; ++p, --Len)
+		h = HashRot(h ^ (*p * HASH_P5),11) * HASH_P1;
+
+	h ^= h >> 33;
+	h *= HASH_P2;
+	h ^= h >> 29;
+	h *= HASH_P3;
+	h ^= h >> 32;
+
+	return (h);
+}
+
+// Mixes 8 bytes into one of the sums
+unsigned long long HashRound(unsigned long long Acc, unsigned long long Val)
+{
+	return (HashRot(Acc + Val * HASH_P2,31) * HASH_P1);
+}
+
+// Next 8 bytes as a little endian number
+unsigned long long HashGet(const unsigned char *p)
+{
+	unsigned long long Val;
+
+	memcpy(&Val,p,8);
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+	Val = __builtin_bswap64(Val);
+#endif
+
+	return (Val);
+}
+
+unsigned long long HashRot(unsigned long long Val, int Bits)
+{
+	return ((Val << Bits) | (Val >> (64 - Bits)));
+}
+
+// CkptFile() Function
+//   Makes the checkpoint file name for
+//   an output file, "outfile.ckpt".
+//
+// Inputs: outfile - Output file name
+//
+// Outputs: Name to free(), NULL if out of memory
+//
+char *CkptFile(const char *outfile)
+{
+	char *Name = (char *) malloc(strlen(outfile) + 6);
+
+	if (NULL != Name)
+		sprintf(Name,"%s.ckpt",outfile);
+
+	return (Name);
+}
+
+// LoadCkpt() Function
+//   Reads the checkpoint left by an
+//   earlier conversion to outfile.
+//
+// Inputs: outfile - Output file name
+//         Ckpt - Set to where that conversion got to
+//
+// Outputs: 1 if loaded, 0 if there isn't one, -1 if it's bad
+//
+int LoadCkpt(const char *outfile, ConvCkpt *Ckpt)
+{
+	char *Name;  // Checkpoint file
+	FILE *fp;
+	int Ok;
+
+	if (NULL == (Name = CkptFile(outfile)))
+		return (-1);
+	fp = fopen(Name,"r");
+	free(Name);
+	if (NULL == fp)
+		return (0);
+
+	Ok = (7 == fscanf(fp,"DualExtrude checkpoint in %llu out %llu lines %d left %d right %d firste %lf ratio %lf",
+		&Ckpt->InPos,&Ckpt->OutPos,&Ckpt->Lines,&Ckpt->LeftUsed,&Ckpt->RightUsed,&Ckpt->FirstE,&Ckpt->Ratio[0]));
+
+	// One more ratio for each toolhead past two
+	for (Ckpt->Heads = 2; Ok && Ckpt->Heads < MAXHEADS
+			&& 1 == fscanf(fp," ratio %lf",&Ckpt->Ratio[Ckpt->Heads - 1]); ++Ckpt->Heads)
+		;
+	if (!Ok || 1 != fscanf(fp," emode %d",&Ckpt->RelativeE))
+		Ckpt->RelativeE = 0;  // Not in older ones
+	Ckpt->SetE = 0;
+	fclose(fp);
+
+	return (Ok ? 1 : -1);
+}
+
+// NextCkpt() Function
+//   Saves a checkpoint if the conversion
+//   is CKPTSIZE past the last one.
+//
+// Inputs: in - Input file, after the last line converted
+//         out - Output file
+//         cnt - Lines converted
+//
+// Outputs: Sucess/Failure
+//
+int NextCkpt(InFile *in, OutFile *out, int cnt)
+{
+	if (NULL == out->CkptName || in->Base + in->Pos - out->CkptIn < CKPTSIZE)
+		return (1);
+
+	// The layers up to here go with it
+	return (SaveCkpt(in,out,cnt) && (NULL == out->IdxName || SaveIndex(out)));
+}
+
+// SaveCkpt() Function
+//   Writes everything converted so far
+//   to disk, then saves where we are and
+//   the conversion state in out->CkptName.
+//
+//   The checkpoint is written to a temp
+//   file and renamed, so a crash leaves
+//   the old one or the new one.
+//
+// Inputs: in - Input file, after the last line converted
+//         out - Output file
+//         cnt - Lines converted
+//
+// Outputs: Sucess/Failure
+//
+int SaveCkpt(InFile *in, OutFile *out, int cnt)
+{
+	char *Tmp;  // Temp file for the new checkpoint
+	FILE *fp;
+	int n;
+	int Ok;
+
+	if (NULL == (Tmp = (char *) malloc(strlen(out->CkptName) + 5)))
+		return (0);
+	sprintf(Tmp,"%s.tmp",out->CkptName);
+
+	Ok = SyncOut(out) && NULL != (fp = fopen(Tmp,"w"));
+	if (Ok)
+	{
+		// %a keeps the doubles exact
+		fprintf(fp,"DualExtrude checkpoint\nin %llu\nout %llu\nlines %d\nleft %d\nright %d\nfirste %a\n",
+			in->Base + in->Pos,out->Written,cnt,LeftUsed,RightUsed,FirstE);
+		for (n = 0; n < NumHeads - 1; ++n)
+			fprintf(fp,"ratio %a\n",Ratio[n]);
+		fprintf(fp,"emode %d\n",RelativeE);
+		Ok = !fflush(fp);
+#ifdef _WIN32
+		Ok = Ok && !_commit(_fileno(fp));
+#else
+		Ok = Ok && !fsync(fileno(fp));
+#endif
+		Ok = !fclose(fp) && Ok;
+#ifdef _WIN32
+		remove(out->CkptName);  // rename() won't replace it
+#endif
+		Ok = Ok && !rename(Tmp,out->CkptName);
+		if (!Ok)
+			remove(Tmp);
+	}
+	free(Tmp);
+
+	if (!Ok)
+	{
+		fprintf(Msg,"ERROR: Can't save checkpoint: %s\n\n",out->CkptName);
+		return (0);
+	}
+	out->CkptIn = in->Base + in->Pos;
+
+	return (1);
+}
+
+// IndexFile() Function
+//   Makes the layer index file name
+//   for an output file.
+//
+// Inputs: outfile - Output file name
+//
+// Outputs: outfile.idx, NULL if out of memory
+//
+char *IndexFile(const char *outfile)
+{
+	char *Name = (char *) malloc(strlen(outfile) + 5);
+
+	if (NULL != Name)
+		sprintf(Name,"%s.idx",outfile);
+
+	return (Name);
+}
+
+// LoadIndex() Function
+//   Reads the layer index left by an
+//   earlier conversion to outfile.
+//
+// Inputs: outfile - Output file name
+//         Index - Set to its layers, empty to start with
+//
+// Outputs: 1 if loaded, 0 if there isn't one, -1 if it's bad
+//
+int LoadIndex(const char *outfile, LayerIndex *Index)
+{
+	char *Name;  // Index file
+	FILE *fp;
+	LayerMark Mark;  // Layer being read
+	int Heads, Left, Right;  // Same for all of them
+	int n;
+	int Ok;
+
+	if (NULL == (Name = IndexFile(outfile)))
+		return (-1);
+	fp = fopen(Name,"r");
+	free(Name);
+	if (NULL == fp)
+		return (0);
+
+	Ok = (3 == fscanf(fp,"DualExtrude index heads %d left %d right %d",&Heads,&Left,&Right))
+		&& Heads >= 2 && Heads <= MAXHEADS;
+
+	memset(&Mark,0,sizeof(Mark));
+	while (Ok && 7 == fscanf(fp," layer %d z %lf in %llu out %llu lines %d firste %lf emode %d",
+			&Mark.Layer,&Mark.Z,&Mark.At.InPos,&Mark.At.OutPos,&Mark.At.Lines,&Mark.At.FirstE,&Mark.At.RelativeE))
+	{
+		// One ratio for each added toolhead
+		for (n = 0; Ok && n < Heads - 1; ++n)
+			Ok = (1 == fscanf(fp," ratio %lf",&Mark.At.Ratio[n]));
+		Mark.At.LeftUsed = Left;
+		Mark.At.RightUsed = Right;
+		Mark.At.Heads = Heads;
+
+		// They're numbered from 1 in order
+		Ok = Ok && AddLayer(Index,Mark.Z,&Mark.At) && Index->Marks[Index->Num - 1].Layer == Mark.Layer;
+	}
+	Ok = Ok && feof(fp);
+	fclose(fp);
+
+	if (!Ok)
+	{
+		Index->Num = 0;
+		return (-1);
+	}
+
+	return (1);
+}
+
+// SaveIndex() Function
+//   Saves the layers found so far in
+//   out->IdxName, from a temp file that
+//   is renamed like the checkpoint.
+//
+// Inputs: out - Output file
+//
+// Outputs: Sucess/Failure
+//
+int SaveIndex(OutFile *out)
+{
+	char *Tmp;  // Temp file for the new index
+	FILE *fp;
+	const LayerMark *Mark;
+	int n, m;
+	int Ok;
+
+	if (NULL == (Tmp = (char *) malloc(strlen(out->IdxName) + 5)))
+		return (0);
+	sprintf(Tmp,"%s.tmp",out->IdxName);
+
+	Ok = (NULL != (fp = fopen(Tmp,"w")));
+	if (Ok)
+	{
+		fprintf(fp,"DualExtrude index\nheads %d\nleft %d\nright %d\n",NumHeads,LeftUsed,RightUsed);
+
+		// One line for each layer, %a keeps the doubles exact
+		for (n = 0; n < out->Layers.Num; ++n)
+		{
+			Mark = &out->Layers.Marks[n];
+			fprintf(fp,"layer %d z %.10g in %llu out %llu lines %d firste %a emode %d",
+				Mark->Layer,Mark->Z,Mark->At.InPos,Mark->At.OutPos,Mark->At.Lines,Mark->At.FirstE,Mark->At.RelativeE);
+			for (m = 0; m < NumHeads - 1; ++m)
+				fprintf(fp," ratio %a",Mark->At.Ratio[m]);
+			fprintf(fp,"\n");
+		}
+		Ok = !ferror(fp);
+		Ok = !fclose(fp) && Ok;
+#ifdef _WIN32
+		remove(out->IdxName);  // rename() won't replace it
+#endif
+		Ok = Ok && !rename(Tmp,out->IdxName);
+		if (!Ok)
+			remove(Tmp);
+	}
+	free(Tmp);
+
+	if (!Ok)
+	{
+		fprintf(Msg,"ERROR: Can't save layer index: %s\n\n",out->IdxName);
+		return (0);
+	}
+
+	return (1);
+}
+
+// AddLayer() Function
+//   Adds a layer to an index, if the
+//   height is different from the last one.
+//
+// Inputs: Index - Layers so far
+//         Z - Height of a move
+//         At - Where the move is, and the state before it
+//
+// Outputs: Sucess/Failure if out of memory
+//
+int AddLayer(LayerIndex *Index, double Z, const ConvCkpt *At)
+{
+	LayerMark *NewMarks;
+	LayerMark *Mark;
+
+	if (Index->Num && Z == Index->Marks[Index->Num - 1].Z)
+		return (1);  // Same layer
+
+	if (Index->Num == Index->Size)
+	{
+		if (NULL == (NewMarks = (LayerMark *) realloc(Index->Marks,(Index->Size * 2 + 256) * sizeof(LayerMark))))
+			return (0);
+		Index->Marks = NewMarks;
+		Index->Size = Index->Size * 2 + 256;
+	}
+
+	Mark = &Index->Marks[Index->Num];
+	Mark->Layer = Index->Num ? Index->Marks[Index->Num - 1].Layer + 1 : 1;
+	Mark->Z = Z;
+	Mark->At = *At;
+	++Index->Num;
+
+	return (1);
+}
+
+// StateAt() Function
+//   Fills in a ConvCkpt with where a line
+//   is and this thread's conversion state.
+//
+// Inputs: At - Set to the state
+//         InPos - Input offset of the line
+//         OutPos - Output offset it goes to
+//         Lines - Lines before it
+//
+void StateAt(ConvCkpt *At, unsigned long long InPos, unsigned long long OutPos, int Lines)
+{
+	memset(At,0,sizeof(*At));
+	At->InPos = InPos;
+	At->OutPos = OutPos;
+	At->Lines = Lines;
+	At->LeftUsed = LeftUsed;
+	At->RightUsed = RightUsed;
+	At->FirstE = FirstE;
+	At->RelativeE = RelativeE;
+	At->Heads = NumHeads;
+	memcpy(At->Ratio,Ratio,sizeof(Ratio));
+}
+
+// MoveZ() Function
+//   Checks for a G1 that sets Z, where
+//   a new layer might start.
+//
+// Inputs: Line - Line to check
+//         Len - Length of the line
+//         Z - Set to the height
+//
+// Outputs: 1 if it's a G1 with a 'Z', 0 if not
+//
+int MoveZ(const char *Line, size_t Len, double *Z)
+{
+	GLine Parse;
+	GToken Token;
+
+	StartLine(&Parse,Line,Len);
+	if (!NextToken(&Parse,&Token) || G1 != CheckCode(&Token))
+		return (0);
+
+	while (NextToken(&Parse,&Token))
+	{
+		if ('Z' == Token.Letter)
+		{
+			*Z = ParseE(Token.Num,Token.NumLen > 15 ? 15 : Token.NumLen);
+			return (1);
+		}
+	}
+
+	return (0);
+}
+
+// LayerStart() Function
+//   Finds the --from-layer layer in the
+//   last run's index, to carry on from.
+//
+//   If the ratio changed and 'E's are
+//   positions, the added toolheads are set
+//   to where the new ratio has them first,
+//   so they don't jump at the first move.
+//
+// Inputs: infile - File to convert
+//         outfile - Output file, with outfile.idx
+//         Ckpt - Set to the start of the layer
+//
+// Outputs: Sucess/Failure
+//
+int LayerStart(char *infile, const char *outfile, ConvCkpt *Ckpt)
+{
+	LayerIndex Index;  // Layers from the last run
+	const ConvCkpt *Before;  // Layer before it, made with the old ratio
+	ConvCkpt Start;  // Start of the file
+	double E = 0;  // 'E' at the start of the layer
+	int Found;
+	int n;
+
+	memset(&Index,0,sizeof(Index));
+	switch (LoadIndex(outfile,&Index))
+	{
+	case 0:
+		fprintf(Msg,"ERROR: No layer index, convert it with --index first: %s\n\n",outfile);
+		return (0);
+	case -1:
+		free(Index.Marks);
+		fprintf(Msg,"ERROR: Bad layer index for: %s\n\n",outfile);
+		return (0);
+	}
+
+	for (n = 0; n < Index.Num && Index.Marks[n].Layer != FromLayer; ++n)
+		;
+	if (n == Index.Num || Index.Marks[n].At.Heads != NumHeads)
+	{
+		free(Index.Marks);
+		if (n == Index.Num)
+			fprintf(Msg,"ERROR: No layer %d in the layer index, it has %d\n\n",FromLayer,Index.Num);
+		else
+			fprintf(Msg,"ERROR: Layer index was made with a different --heads\n\n");
+		return (0);
+	}
+	*Ckpt = Index.Marks[n].At;
+	Before = &Index.Marks[n ? n - 1 : n].At;
+
+	if (!Ckpt->RelativeE && Ckpt->FirstE > 0 && memcmp(Before->Ratio,Ratio,(NumHeads - 1) * sizeof(double)))
+	{
+		// Find the last 'E' before it, from the layer before or the start of the file
+		Found = n ? FindLastE(infile,Before,Ckpt->InPos,&E) : 0;
+		if (!Found)
+		{
+			memset(&Start,0,sizeof(Start));
+			Found = FindLastE(infile,&Start,Ckpt->InPos,&E);
+		}
+		if (Found < 0)
+		{
+			free(Index.Marks);
+			fprintf(Msg,"ERROR: Can't read input file: %s\n\n",infile);
+			return (0);
+		}
+		Ckpt->SetE = Found;
+		Ckpt->LastE = E;
+	}
+	free(Index.Marks);
+
+	return (1);
+}
+
+// FindLastE() Function
+//   Reads part of the input for the last
+//   'E' position set before a point.
+//
+// Inputs: infile - File to read
+//         From - Where to start, with the 'E' mode there
+//         To - Where to stop, the start of a line
+//         E - Set to the last 'E' position
+//
+// Outputs: 1 if found, 0 if not or it's not known after
+//          a change from relative 'E's, -1 on errors
+//
+int FindLastE(char *infile, const ConvCkpt *From, unsigned long long To, double *E)
+{
+	InFile in;  // Input file
+	const char *Line;
+	size_t Len;
+	GLine Parse;
+	GToken Token;
+	int Relative = From->RelativeE;  // 'E's are distances
+	int Code;
+	int Found = 0;
+
+	if (!OpenIn(&in,infile,UseReadThread ? OPEN_AHEAD : OPEN_MAP))
+		return (-1);
+	if (!SkipIn(&in,From->InPos))
+	{
+		CloseIn(&in);
+		return (-1);
+	}
+
+	while (in.Base + in.Pos < To && ReadLine(&in,&Line,&Len))
+	{
+		StartLine(&Parse,Line,Len);
+		if (!NextToken(&Parse,&Token))
+			continue;
+
+		switch (Code = CheckCode(&Token))
+		{
+		case M82:  // Back to positions, where from isn't known
+		case G90:
+			if (Relative)
+				Found = 0;
+			Relative = 0;
+			break;
+		case M83:
+		case G91:
+			Relative = 1;
+			break;
+		case G1:
+		case G92:
+			if (G1 == Code && Relative)
+				break;
+			while (NextToken(&Parse,&Token))
+			{
+				if ('E' == Token.Letter || 'A' == Token.Letter || 'B' == Token.Letter)
+				{
+					*E = ParseE(Token.Num,Token.NumLen > 15 ? 15 : Token.NumLen);
+					Found = 1;
+				}
+			}
+			break;
+		}
+	}
+	if (in.Failed)
+		Found = -1;
+	CloseIn(&in);
+
+	return (Found);
+}
+
+// PutLine() Function
+//   Converts a line straight into the
+//   output buffer.
+//
+// Inputs: out - Output file
+//         Line - Line to convert
+//         Len - Length of the line
+//         cnt - Line number for error messages
+//         Check - Also check the line for a second used toolhead
+//
+// Outputs: Sucess/Failure
+//
+int PutLine(OutFile *out, const char *Line, size_t Len, int cnt, int Check)
+{
+	char *buf;  // Where the new line goes
+	size_t Room = Len + MAXOUT;  // Room for it
+	size_t OutLen;  // Length of the new line
+	double OldE = FirstE;  // To start over
+	int InBig;  // Converted in out->Big
+	int Ret;
+
+	if (BinOut)
+		return (PutBinLine(out,Line,Len,cnt,Check));
+
+	for (;;)
+	{
+		// Lines that fit go straight into the output buffer,
+		// longer ones go thru out->Big, which is kept for the next one
+		if ((InBig = (Room > out->Size)))
+		{
+			if (Room > out->BigSize)
+			{
+				free(out->Big);
+				if (NULL == (out->Big = (char *) malloc(Room)))
+				{
+					out->BigSize = 0;
+					if (cnt)
+						fprintf(Msg,"ERROR: Out of memory in line %d\n\n",cnt);
+					return (0);
+				}
+				out->BigSize = Room;
+			}
+			buf = out->Big;
+			Room = out->BigSize;
+		}
+		else
+		{
+			buf = OutSpace(out,Room);
+			Room = out->Size - out->Len;
+		}
+
+		if ((Ret = ConvLine(Line,Len,buf,Room,&OutLen,cnt,Check)) >= 0)
+			break;
+
+		// Didn't fit, try again with more room
+		FirstE = OldE;
+		Room *= 2;
+	}
+	if (!Ret)
+		return (0);
+
+	if (!OutLen)  // Unchanged, copy it
+	{
+		if (InBig)
+			PutOut(out,Line,Len);
+		else
+		{
+			memcpy(buf,Line,Len);
+			out->Len += Len;
+		}
+	}
+	else if (InBig)
+		PutOut(out,buf,OutLen);
+	else
+		out->Len += OutLen;
+
+	return (1);
+}
+
+// PutBinLine() Function
+//   Converts a line for the binary format.
+//   G1 moves that only have X/Y/Z/F/E become
+//   a move record, everything else is stored
+//   as strings.
+//
+// Inputs: out - Output file
+//         Line - Line to convert
+//         Len - Length of the line
+//         cnt - Line number for error messages
+//         Check - Also check the line for a second used toolhead
+//
+// Outputs: Sucess/Failure
+//
+int PutBinLine(OutFile *out, const char *Line, size_t Len, int cnt, int Check)
+{
+	GLine Parse;  // Line being parsed
+	GToken Token;  // First token
+	const char *Text;  // Converted text line(s)
+	size_t TextLen;  // Length of Text
+	const char *End;  // End of one of the lines
+	size_t n;
+
+	// Try for a move record
+	StartLine(&Parse,Line,Len);
+	if (NextToken(&Parse,&Token) && G1 == CheckCode(&Token))
+	{
+		if (0 != (n = PutMove(&Parse,OutSpace(out,MAXREC))))
+		{
+			out->Len += n;
+			return (1);
+		}
+	}
+
+	// No, convert it as text and store each line
+	if (!ConvText(out,Line,Len,cnt,Check,&Text,&TextLen))
+		return (0);
+	while (TextLen)
+	{
+		if (NULL != (End = (const char *) memchr(Text,'\012',TextLen)))
+			n = (size_t) (End - Text);
+		else
+			n = TextLen;
+		PutString(out,Text,n);
+		if (NULL != End)  // Skip the '\n'
+			++n;
+		Text += n;
+		TextLen -= n;
+	}
+
+	return (1);
+}
+
+// ConvText() Function
+//   Converts a line into out->Big, with
+//   as much room as it needs.
+//
+// Inputs: out - Output file
+//         Line - Line to convert
+//         Len - Length of the line
+//         cnt - Line number for error messages
+//         Check - Also check the line for a second used toolhead
+//         Text - Set to the new line(s), or Line if it's unchanged
+//         TextLen - Set to the length of Text
+//
+// Outputs: Sucess/Failure
+//
+int ConvText(OutFile *out, const char *Line, size_t Len, int cnt, int Check, const char **Text, size_t *TextLen)
+{
+	size_t Room = Len + MAXOUT;  // Room for the new line(s)
+	double OldE = FirstE;  // To start over
+	int Ret;
+
+	for (;;)
+	{
+		if (Room > out->BigSize)
+		{
+			free(out->Big);
+			if (NULL == (out->Big = (char *) malloc(Room)))
+			{
+				out->BigSize = 0;
+				if (cnt)
+					fprintf(Msg,"ERROR: Out of memory in line %d\n\n",cnt);
+				return (0);
+			}
+			out->BigSize = Room;
+		}
+
+		if ((Ret = ConvLine(Line,Len,out->Big,out->BigSize,TextLen,cnt,Check)) >= 0)
+			break;
+
+		// Didn't fit, try again with more room
+		FirstE = OldE;
+		Room = out->BigSize * 2;
+	}
+	if (!Ret)
+		return (0);
+
+	if (*TextLen)
+		*Text = out->Big;
+	else
+	{  // Unchanged
+		*Text = Line;
+		*TextLen = Len;
+	}
+
+	return (1);
+}
+
+// ConvArena() Function
+//   Converts the rest of a file for --arena.
+//   Each block of lines is parsed into a
+//   CmdBlock, converted with ConvBlock(),
+//   then written with PutBlock().
+//
+// Inputs: in - Input file
+//         out - Output file
+//         cnt - Lines converted so far, updated
+//         Check - Also check the lines for a second used toolhead
+//
+// Outputs: Sucess/Failure
+//
+int ConvArena(InFile *in, OutFile *out, int *cnt, int Check)
+{
+	Arena Mem = { NULL };  // Where the block is, reused for each one
+	CmdBlock Block;  // Lines being converted
+	const char *Line;  // Current input line
+	size_t Len;  // Length of the input line
+	char *Copy;  // Line kept in the arena
+	int Stable = (NULL == in->fp && NULL == in->Zip);  // Lines stay put when mapped
+	int Ok = 1;
+
+	while (Ok)
+	{
+		ArenaReset(&Mem);
+		if (!StartBlock(&Block,&Mem,CMDLINES))
+			goto Oom;
+
+		// Parse a block, read lines won't be there after the next read
+		while (Block.Num < CMDLINES && ReadLine(in,&Line,&Len))
+		{
+			if (!Stable)
+			{
+				if (NULL == (Copy = (char *) ArenaAlloc(&Mem,Len)))
+					goto Oom;
+				memcpy(Copy,Line,Len);
+				Line = Copy;
+			}
+			AddCmd(&Block,Line,Len);
+		}
+		if (in->Failed || !Block.Num)
+			break;
+
+		// One pass to convert it, add more passes after this one
+		if ((Ok = ConvBlock(&Block,&Mem,out,*cnt,Check)))
+			PutBlock(out,&Block);
+		*cnt += Block.Num;
+	}
+	ArenaFree(&Mem);
+
+	return (Ok);
+
+Oom:
+	ArenaFree(&Mem);
+	fprintf(Msg,"ERROR: Out of memory in line %d\n\n",*cnt + 1);
+	return (0);
+}
+
+// StartBlock() Function
+//   Sets up an empty CmdBlock.
+//
+// Inputs: Block - Block to set up
+//         Mem - Arena for its arrays
+//         Size - Commands it can hold
+//
+// Outputs: Sucess/Failure
+//
+int StartBlock(CmdBlock *Block, Arena *Mem, int Size)
+{
+	int Field;
+
+	memset(Block,0,sizeof(*Block));
+	Block->Code = (signed char *) ArenaAlloc(Mem,(size_t) Size);
+	Block->Mask = (unsigned short *) ArenaAlloc(Mem,Size * sizeof(unsigned short));
+	Block->Places = (unsigned int *) ArenaAlloc(Mem,Size * sizeof(unsigned int));
+	Block->Text = (const char **) ArenaAlloc(Mem,Size * sizeof(const char *));
+	Block->TextLen = (size_t *) ArenaAlloc(Mem,Size * sizeof(size_t));
+	if (NULL == Block->Code || NULL == Block->Mask || NULL == Block->Places
+		|| NULL == Block->Text || NULL == Block->TextLen)
+		return (0);
+
+	// Only the toolheads being used
+	for (Field = 0; Field < CMD_A + NumHeads; ++Field)
+	{
+		if (NULL == (Block->Val[Field] = (long long *) ArenaAlloc(Mem,Size * sizeof(long long))))
+			return (0);
+	}
+
+	return (1);
+}
+
+// AddCmd() Function
+//   Parses a line onto the end of a CmdBlock.
+//   G1s with X/Y/Z/F/E in that order, each one
+//   a value that prints back the same, get their
+//   fields filled in. The rest are kept as text.
+//
+// Inputs: Block - Block with room for it
+//         Line - Line to add, kept until the block is written
+//         Len - Length of the line
+//
+void AddCmd(CmdBlock *Block, const char *Line, size_t Len)
+{
+	GLine Parse;  // Line being parsed
+	GToken Token;  // Next token
+	int n = Block->Num++;  // Where it goes
+	int Field;  // Field for this token
+	int Last = -1;  // Field before it, they have to be in order
+	int Scale;  // Places the field is kept to
+	int Places;  // Places it was written with
+	unsigned int AllPlaces = 0;
+	int Mask = 0;  // Fields found
+	long long Val;
+
+	Block->Text[n] = Line;
+	Block->TextLen[n] = Len;
+	Block->Mask[n] = 0;
+
+	StartLine(&Parse,Line,Len);
+	Block->Code[n] = (signed char) (NextToken(&Parse,&Token) ? CheckCode(&Token) : NOTOKENS);
+	if (G1 != Block->Code[n])
+		return;
+
+	while (NextToken(&Parse,&Token))
+	{
+		switch (Token.Letter)
+		{
+		case 'X': Field = CMD_X; break;
+		case 'Y': Field = CMD_Y; break;
+		case 'Z': Field = CMD_Z; break;
+		case 'F': Field = CMD_F; break;
+		case 'E':
+			if (Token.Len > 15)  // ConvLine() has an error for that
+				return;
+			Field = CMD_A + (RightUsed ? 0 : 1);
+			break;
+		default:
+			return;  // Something only text can hold
+		}
+		Scale = Field < CMD_A ? 3 : 5;
+		if (Field <= Last || !CmdNum(Token.Num,Token.NumLen,Scale,&Val,&Places))
+			return;
+
+		Block->Val[Field][n] = Val;
+		AllPlaces |= (unsigned int) Places << (Field * 4);
+		Mask |= 1 << Field;
+		Last = Field;
+	}
+
+	Block->Mask[n] = (unsigned short) Mask;
+	Block->Places[n] = AllPlaces;
+}
+
+// CmdNum() Function
+//   Reads a value for a CmdBlock field, if
+//   PutNum() can write it back the same way.
+//
+// Inputs: p - Start of the value
+//         Len - Chars available
+//         Scale - Decimal places it's kept to
+//         Val - Set to the value times 10^Scale
+//         Places - Set to the places written, CMD_DOT if there's no '.'
+//
+// Outputs: 1 if it can be kept, 0 for anything but a plain
+//          decimal without extra zeros in front or a '+'
+//
+int CmdNum(const char *p, size_t Len, int Scale, long long *Val, int *Places)
+{
+	const char *End = p + Len;
+	int Neg = 0;
+	int Digits = 0;  // Digits used
+	int Frac = -1;  // Decimal places, -1 before the '.'
+	long long Result = 0;
+
+	if (p < End && '-' == *p)
+	{
+		Neg = 1;
+		++p;
+	}
+
+	// A digit first, and only a lone '0' can start with one
+	if (p >= End || *p < '0' || *p > '9' || ('0' == *p && p + 1 < End && '.' != p[1]))
+		return (0);
+
+	for (; p < End; ++p)
+	{
+		if ('.' == *p && Frac < 0)
+			Frac = 0;
+		else if (*p >= '0' && *p <= '9' && Digits < 15 && Frac < Scale)
+		{
+			Result = (Result * 10) + (*p - '0');
+			++Digits;
+			if (Frac >= 0)
+				++Frac;
+		}
+		else
+			return (0);
+	}
+	if (0 == Frac || (Neg && !Result))  // Nothing after the '.', or -0
+		return (0);
+
+	*Places = Frac < 0 ? CMD_DOT : Frac;
+	for (Frac = Frac < 0 ? 0 : Frac; Frac < Scale; ++Frac)
+		Result *= 10;
+	*Val = Neg ? -Result : Result;
+
+	return (1);
+}
+
+// ConvBlock() Function
+//   Converts a CmdBlock the same way ConvLine()
+//   converts each line. Moves get the 'E' for
+//   each added toolhead, text goes thru ConvLine().
+//
+// Inputs: Block - Block to convert, changed in place
+//         Mem - Arena for the new text lines
+//         out - Output file, its buffer is used to convert text
+//         cnt - Line number before the block, for error messages
+//         Check - Also check the lines for a second used toolhead
+//
+// Outputs: Sucess/Failure
+//
+int ConvBlock(CmdBlock *Block, Arena *Mem, OutFile *out, int cnt, int Check)
+{
+	static const double Pow10[6] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5 };
+	static const long long Scale10[6] = { 1, 10, 100, 1000, 10000, 100000 };
+	int Used = RightUsed ? 0 : 1;  // Toolhead in the input, its 'E' goes last
+	int UsedBit = 1 << (CMD_A + Used);
+	double NewE[MAXHEADS];  // 'E' for each toolhead, in .00001 units
+	double CurrentE;  // Current 'E' value
+	double Base;  // 'E' the added extruders' distances are from
+	long long E;  // 'E' as read
+	unsigned int Places;  // Places it was written with
+	unsigned int Shift;
+	const char *Text;  // Converted text line(s)
+	size_t TextLen;  // Length of Text
+	char *Copy;  // Text kept in the arena
+	int Head, n, k;
+
+	for (n = 0; n < Block->Num; ++n)
+	{
+		if (Block->Mask[n] & UsedBit)
+		{
+			// The same double ParseE() gets from the text
+			E = Block->Val[CMD_A + Used][n];
+			Places = (Block->Places[n] >> ((CMD_A + Used) * 4)) & 15;
+			if (CMD_DOT == Places)
+				CurrentE = (double) ((E < 0 ? -E : E) / Scale10[5]);
+			else
+				CurrentE = (double) ((E < 0 ? -E : E) / Scale10[5 - Places]) / Pow10[Places];
+			if (E < 0)
+				CurrentE = -CurrentE;
+
+			if (FirstE > 0 || RelativeE)  // Did we see an 'E' before, or is it a distance?
+			{  // Yes, figure new values for the added extruders
+				Base = RelativeE ? 0 : FirstE;
+				for (k = 0; k < NumHeads - 1; ++k)
+				{
+					NewE[k] = floor(((((CurrentE - Base) * Ratio[k]) + Base) * 100000.0) + 0.5);
+					if (!(fabs(NewE[k]) < 4503599627370496.0))  // PutFixed() uses printf() for those
+						break;
+				}
+				if (k < NumHeads - 1)
+					Block->Mask[n] = 0;  // Leave it to ConvLine()
+				else
+				{
+					for (k = 0; k < NumHeads - 1; ++k)
+					{
+						Head = k + (k >= Used);  // Skip the used one
+						Shift = (unsigned int) (CMD_A + Head) * 4;
+						Block->Val[CMD_A + Head][n] = (long long) NewE[k];
+						Block->Places[n] = (Block->Places[n] & ~(15U << Shift)) | (5U << Shift);
+						Block->Mask[n] |= 1 << (CMD_A + Head);
+					}
+					Block->Mask[n] |= 1 << CMD_NEW;
+					++Stats.Rewrites;
+				}
+			}
+			else
+			{  // No, all of them get what we got, and save the first 'E'
+				for (Head = 0; Head < NumHeads; ++Head)
+				{
+					Shift = (unsigned int) (CMD_A + Head) * 4;
+					Block->Val[CMD_A + Head][n] = E;
+					Block->Places[n] = (Block->Places[n] & ~(15U << Shift)) | (Places << Shift);
+					Block->Mask[n] |= 1 << (CMD_A + Head);
+				}
+				FirstE = CurrentE;
+			}
+		}
+		if (Block->Mask[n])
+		{
+			++Stats.Codes[G1];
+			continue;
+		}
+
+		// Text, converted as it always was
+		if (!ConvText(out,Block->Text[n],Block->TextLen[n],cnt + n + 1,Check,&Text,&TextLen))
+			return (0);
+		if (Text != Block->Text[n])
+		{  // The next line goes in the same buffer, keep this one
+			if (NULL == (Copy = (char *) ArenaAlloc(Mem,TextLen)))
+			{
+				fprintf(Msg,"ERROR: Out of memory in line %d\n\n",cnt + n + 1);
+				return (0);
+			}
+			memcpy(Copy,Text,TextLen);
+			Block->Text[n] = Copy;
+		}
+		Block->TextLen[n] = TextLen;
+	}
+
+	return (1);
+}
+
+// PutBlock() Function
+//   Writes a CmdBlock as text, moves the same
+//   way ConvLine() would have written them.
+//
+// Inputs: out - Output file
+//         Block - Block to write
+//
+void PutBlock(OutFile *out, const CmdBlock *Block)
+{
+	int Used = RightUsed ? 0 : 1;  // Toolhead in the input
+	OutLine Out;  // Move being built
+	int Mask;  // Fields in it
+	int Field, Head, n, k;
+
+	for (n = 0; n < Block->Num; ++n)
+	{
+		if (!(Mask = Block->Mask[n]))
+		{
+			PutOut(out,Block->Text[n],Block->TextLen[n]);
+			continue;
+		}
+
+		StartOut(&Out,OutSpace(out,MAXCMD));
+		PutSpan(&Out,"G1",2);
+		for (Field = CMD_X; Field <= CMD_F; ++Field)
+		{
+			if (Mask & (1 << Field))
+			{
+				PutChar(&Out,' ');
+				PutChar(&Out,"XYZF"[Field]);
+				PutNum(&Out,Block->Val[Field][n],3,(int) (Block->Places[n] >> (Field * 4)) & 15);
+			}
+		}
+
+		// The added toolheads first once they're figured, then the used one
+		for (k = 0; k < NumHeads; ++k)
+		{
+			if (Mask & (1 << CMD_NEW))
+				Head = k < NumHeads - 1 ? k + (k >= Used) : Used;
+			else
+				Head = k;
+			Field = CMD_A + Head;
+			if (Mask & (1 << Field))
+			{
+				PutChar(&Out,' ');
+				PutChar(&Out,(char) ('A' + Head));
+				PutNum(&Out,Block->Val[Field][n],5,(int) (Block->Places[n] >> (Field * 4)) & 15);
+			}
+		}
+		PutChar(&Out,'\012');
+		out->Len += (size_t) (Out.Cur - Out.Start);
+	}
+}
+
+// PutNum() Function
+//   Writes a fixed point number with the
+//   places it was read with.
+//
+// Inputs: Out - Line being built
+//         Val - Value times 10^Scale
+//         Scale - Decimal places in Val
+//         Places - Places to write, CMD_DOT for none and no '.'
+//
+void PutNum(OutLine *Out, long long Val, int Scale, int Places)
+{
+	static const unsigned long long Scale10[6] = { 1, 10, 100, 1000, 10000, 100000 };
+	static const char Pairs[] = "00010203040506070809101112131415161718192021222324"
+		"25262728293031323334353637383940414243444546474849505152535455565758596061626364656667686970"
+		"7172737475767778798081828384858687888990919293949596979899";
+	char Digits[32];  // The number, built backwards two digits at a time
+	char *p = Digits + sizeof(Digits);
+	unsigned long long Abs = Val < 0 ? 0ULL - (unsigned long long) Val : (unsigned long long) Val;
+	unsigned long long Part;
+	int n;
+
+	if (CMD_DOT != Places)
+	{
+		Part = (Abs % Scale10[Scale]) / Scale10[Scale - Places];
+		for (n = Places; n >= 2; n -= 2, Part /= 100)
+		{
+			p -= 2;
+			memcpy(p,Pairs + (Part % 100) * 2,2);
+		}
+		if (n)
+			*--p = (char) ('0' + Part);
+		*--p = '.';
+	}
+
+	for (Part = Abs / Scale10[Scale]; Part >= 100; Part /= 100)
+	{
+		p -= 2;
+		memcpy(p,Pairs + (Part % 100) * 2,2);
+	}
+	if (Part >= 10)
+	{
+		p -= 2;
+		memcpy(p,Pairs + Part * 2,2);
+	}
+	else
+		*--p = (char) ('0' + Part);
+	if (Val < 0)
+		*--p = '-';
+
+	PutSpan(Out,p,(size_t) (Digits + sizeof(Digits) - p));
+}
+
+// ArenaAlloc() Function
+//   Hands out memory from an arena, 16 byte
+//   aligned. It's only freed with the rest.
+//
+// Inputs: Mem - Arena to use
+//         Len - Bytes wanted
+//
+// Outputs: The memory, NULL if out of memory
+//
+void *ArenaAlloc(Arena *Mem, size_t Len)
+{
+	ArenaChunk *Chunk = Mem->Head;
+	size_t Size;
+	void *p;
+
+	Len = (Len + 15) & ~(size_t) 15;
+	if (NULL == Chunk || Chunk->Size - Chunk->Used < Len)
+	{
+		Size = Len > ARENACHUNK ? Len : ARENACHUNK;
+		if (NULL == (Chunk = (ArenaChunk *) malloc(sizeof(ArenaChunk) + Size)))
+			return (NULL);
+		Chunk->Next = Mem->Head;
+		Chunk->Size = Size;
+		Chunk->Used = 0;
+		Mem->Head = Chunk;
+	}
+
+	p = (char *) (Chunk + 1) + Chunk->Used;
+	Chunk->Used += Len;
+
+	return (p);
+}
+
+// ArenaReset() Function
+//   Takes back everything handed out, keeping
+//   the newest chunk to hand out again.
+//
+// Inputs: Mem - Arena to reset
+//
+void ArenaReset(Arena *Mem)
+{
+	ArenaChunk *Chunk, *Next;
+
+	if (NULL == Mem->Head)
+		return;
+
+	for (Chunk = Mem->Head->Next; NULL != Chunk; Chunk = Next)
+	{
+		Next = Chunk->Next;
+		free(Chunk);
+	}
+	Mem->Head->Next = NULL;
+	Mem->Head->Used = 0;
+}
+
+// ArenaFree() Function
+//   Frees all of an arena.
+//
+// Inputs: Mem - Arena to free
+//
+void ArenaFree(Arena *Mem)
+{
+	ArenaChunk *Chunk, *Next;
+
+	for (Chunk = Mem->Head; NULL != Chunk; Chunk = Next)
+	{
+		Next = Chunk->Next;
+		free(Chunk);
+	}
+	Mem->Head = NULL;
+}
+
+// PutMove() Function
+//   Builds a move record from the rest of
+//   a G1 line, the same move ConvLine()
+//   would output.
+//
+// Inputs: Parse - Line, after the G1
+//         buf - Where the record goes, MAXREC bytes
+//
+// Outputs: Length of the record, 0 if the line needs to be text
+//
+size_t PutMove(GLine *Parse, char *buf)
+{
+	GToken Token;  // Next token
+	long long Val[6];  // Value for each field
+	int Mask = 0;  // Fields found
+	int Field;  // Field for this token
+	double OldE = FirstE;  // To put back if we give up
+	double CurrentE;  // Current 'E' value
+	double NewE;  // 'E' for second extruder
+	long long OldUnits;  // Current 'E' in .00001 units
+	unsigned long Rewrites = 0;  // 'E's rewritten, for --stats
+	char *p;
+
+	while (NextToken(Parse,&Token))
+	{
+		switch (Token.Letter)
+		{
+		case 'X': Field = BIN_X; break;
+		case 'Y': Field = BIN_Y; break;
+		case 'Z': Field = BIN_Z; break;
+		case 'F': Field = BIN_F; break;
+		case 'E':
+		case 'A':
+		case 'B': Field = BIN_A; break;
+		default: goto Text;  // Something only text can hold
+		}
+		if (Mask & (1 << Field))  // Twice on one line
+			goto Text;
+
+		if (BIN_A != Field)
+		{
+			if (!ParseFixed(Token.Num,Token.NumLen,3,&Val[Field])
+				|| Val[Field] < -2147483647 || Val[Field] > 2147483647)
+				goto Text;
+			Mask |= 1 << Field;
+			continue;
+		}
+
+		// Same as the G1 case in ConvLine()
+		if (Token.Len > 15 || !ParseFixed(Token.Num,Token.NumLen,5,&OldUnits))
+			goto Text;
+		CurrentE = ParseE(Token.Num,Token.NumLen);
+		if (RelativeE)
+		{
+			NewE = floor((CurrentE * Ratio[0] * 100000.0) + 0.5);
+			if (!(fabs(NewE) < 4e18))
+				goto Text;
+
+			++Rewrites;
+			Val[BIN_A] = RightUsed ? OldUnits : (long long) NewE;
+			Val[BIN_B] = RightUsed ? (long long) NewE : OldUnits;
+		}
+		else if (FirstE > 0)
+		{
+			NewE = ((CurrentE - FirstE) * Ratio[0]) + FirstE;
+			NewE = floor((NewE * 100000.0) + 0.5);
+			if (!(fabs(NewE) < 4e18))
+				goto Text;
+
+			++Rewrites;
+			Val[BIN_A] = RightUsed ? OldUnits : (long long) NewE;
+			Val[BIN_B] = RightUsed ? (long long) NewE : OldUnits;
+		}
+		else
+		{
+			Val[BIN_A] = Val[BIN_B] = OldUnits;
+			FirstE = CurrentE; // Save first one
+		}
+		Mask |= (1 << BIN_A) | (1 << BIN_B);
+	}
+
+	// Fields in order, only the ones found
+	buf[0] = BIN_MOVE;
+	buf[1] = (char) Mask;
+	p = buf + 2;
+	for (Field = BIN_X; Field <= BIN_B; ++Field)
+	{
+		if (Mask & (1 << Field))
+			p = PutLE(p,(unsigned long long) Val[Field],Field < BIN_A ? 4 : 8);
+	}
+
+	++Stats.Codes[G1];
+	Stats.Rewrites += Rewrites;
+
+	return ((size_t) (p - buf));
+
+Text:
+	FirstE = OldE;
+	return (0);
+}
+
+// PutString() Function
+//   Adds a string record, the first time a
+//   string is seen it goes in the string
+//   table, after that just its number.
+//
+// Inputs: out - Output file
+//         Str - String to add, without the '\n'
+//         Len - Length of Str
+//
+void PutString(OutFile *out, const char *Str, size_t Len)
+{
+	char Head[12];  // Record type and length/number
+	char *p;
+
+	if (Len <= MAXSTRLEN)
+	{
+		std::string Key(Str,Len);
+		std::unordered_map<std::string,unsigned long>::iterator Found = out->Strings.find(Key);
+
+		if (out->Strings.end() != Found)
+		{  // Seen it
+			Head[0] = BIN_REF;
+			p = PutVarint(Head + 1,Found->second);
+			PutOut(out,Head,(size_t) (p - Head));
+			return;
+		}
+
+		if (out->Strings.size() < MAXSTRINGS)
+		{  // New one for the table
+			unsigned long Num = (unsigned long) out->Strings.size();
+
+			out->Strings[Key] = Num;
+			Head[0] = BIN_NEW;
+			p = PutVarint(Head + 1,Len);
+			PutOut(out,Head,(size_t) (p - Head));
+			PutOut(out,Str,Len);
+			return;
+		}
+	}
+
+	// Too long, or the table is full
+	Head[0] = BIN_ONCE;
+	p = PutVarint(Head + 1,Len);
+	PutOut(out,Head,(size_t) (p - Head));
+	PutOut(out,Str,Len);
+}
+
+// PutLE() Function
+//   Stores a little endian number.
+//
+// Inputs: p - Where it goes
+//         Val - Number
+//         Bytes - Size of the number
+//
+// Outputs: Next byte after it
+//
+char *PutLE(char *p, unsigned long long Val, int Bytes)
+{
+	while (Bytes--)
+	{
+		*p++ = (char) (Val & 0xff);
+		Val >>= 8;
+	}
+
+	return (p);
+}
+
+// PutVarint() Function
+//   Stores a number 7 bits a byte, low bits
+//   first, with the top bit set on all but
+//   the last byte.
+//
+// Inputs: p - Where it goes, room for 10 bytes
+//         Val - Number
+//
+// Outputs: Next byte after it
+//
+char *PutVarint(char *p, unsigned long long Val)
+{
+	while (Val >= 0x80)
+	{
+		*p++ = (char) ((Val & 0x7f) | 0x80);
+		Val >>= 7;
+	}
+	*p++ = (char) Val;
+
+	return (p);
+}
+
+// ConvLine() Function
+//   Converts one line from a single extruder
+//   file to a "both on" line.
+//
+// Inputs: Line - Line to convert
+//         Len - Length of the line
+//         buf - Buffer for the new line(s)
+//         Room - Size of buf, at least Len + MAXOUT
+//         OutLen - Set to the length of the new line(s),
+//                  0 if the line should be output as is
+//         cnt - Line number for error messages, 0 to not report errors
+//         Check - Also check the line for a second used toolhead
+//
+// Outputs: Sucess/Failure, -1 if buf is too small
+//
+// Only G1 lines can need more than Len + MAXOUT, and those
+// don't change anything but FirstE before running out of room.
+//
+int ConvLine(const char *Line, size_t Len, char *buf, size_t Room, size_t *OutLen, int cnt, int Check)
+{
+	switch (NumHeads)
+	{
+	case 3:
+		return (ConvHeads<3>(Line,Len,buf,Room,OutLen,cnt,Check));
+	case 4:
+		return (ConvHeads<4>(Line,Len,buf,Room,OutLen,cnt,Check));
+	}
+
+	return (ConvHeads<2>(Line,Len,buf,Room,OutLen,cnt,Check));
+}
+
+// ConvHeads() Function
+//   ConvLine() for Heads toolheads. Heads is
+//   fixed when it's compiled, so the loops over
+//   the toolheads unroll and two toolheads are
+//   as quick as they were before --heads.
+//
+// Inputs/Outputs: Same as ConvLine()
+//
+template <int Heads>
+int ConvHeads(const char *Line, size_t Len, char *buf, size_t Room, size_t *OutLen, int cnt, int Check)
+{
+	GLine Parse;  // Line being parsed
+	GToken Token;  // Next token
+	OutLine Out;  // New line(s) being built
+	const char *NotUsed;  // Toolhead code for the one
+					// that's not being used in the input file
+					// Used to drop lines we don't need
+	int Used;  // Toolhead in the input, its 'E' goes last
+	int Head;
+	int n;
+	int Code;  // ID of the M code used in the current linw
+	int Temp;  // Arg from a set temp command
+	GToken Speed; // Speed setting from speed command
+	double CurrentE;  // Current 'E' value
+	double NewE[Heads];  // 'E' for each added extruder
+	double Base;  // 'E' the added extruders' distances are from
+	int Relative;  // 'E's in this line are distances
+	int EWords = 0;  // 'E's in the line
+	unsigned long Rewrites = 0;  // 'E's rewritten, for --stats
+
+	// Set not used toolhead
+	if (RightUsed)
+	{
+		NotUsed = "T1";
+		Used = 0;
+	}
+	else
+	{
+		NotUsed = "T0";
+		Used = 1;
+	}
+	StartLine(&Parse,Line,Len);
+	StartOut(&Out,buf);
+	*OutLen = 0;  // Nothing changed yet
+
+	// Look for a command that we will need to deal with
+	PROF_START(PROF_CLASSIFY);
+	if (NextToken(&Parse,&Token))
+		Code = CheckCode(&Token);
+	else
+		Code = NOTOKENS;
+	PROF_END(PROF_CLASSIFY);
+
+	// Commands that can turn on a toolhead need to be checked
+	// if the file wasn't checked first
+	if (Check && (M101 == Code || M102 == Code || M104 == Code))
+	{
+		if (!CheckLine(Line,Len))
+		{
+			if (cnt)
+				fprintf(Msg,"ERROR: File already uses both extruders, line %d\n\n",cnt);
+			return (0);
+		}
+	}
+
+	switch (Code)
+	{
+	case M101:  // On/Off commands
+	case M102:
+	case M103:
+	case M6:  // Tool change
+		// Check for parameters
+		if (NextToken(&Parse,&Token))
+		{  // Has a second token, should be a "T0" or "T1"
+			if (TokenIs(&Token,NotUsed)) // Check for used extruder
+				break;  // Command for unused extruder, drop it
+		}
+
+		// Needed command, duplicate for each extruder
+		PutStr(&Out,CODES[Code]);
+		PutTools<Heads>(&Out,Out.Start);
+		break;
+	case M104:  // Temp command
+		Temp = 0;  // Zero temp
+
+		// Check for parameters
+		while (NextToken(&Parse,&Token))
+		{ // Got one!
+			if (TokenIs(&Token,NotUsed)) // Check for unused extruder
+				break;  // Command for the "not used" extruder, drop it.
+
+			if ('S' == Token.Letter)  // Check for temp value
+				ParseInt(Token.Num,Token.NumLen,&Temp);  // Get temp
+		}
+
+		// Needed temp command, output duplicates
+		PutStr(&Out,CODES[Code]);
+		PutStr(&Out," S");
+		PutInt(&Out,Temp);
+		PutTools<Heads>(&Out,Out.Start);
+		break;
+	case M108:  // Speed command
+		Speed.Len = 0;  // Clear speed
+
+		// Check for parameters
+		while (NextToken(&Parse,&Token))
+		{ // Got one!
+			if (TokenIs(&Token,NotUsed)) // Check for unused extruder
+				break;  // Command for the "not used" extruder, drop it.
+
+			if ('R' == Token.Letter)  // Check for speed value
+			{
+				if (Token.Len > 15)  // Check for speed command that fits in buffer
+				{
+					if (cnt)
+						fprintf(Msg,"ERROR: Speed command too long in line %d\n\n",cnt);
+					return (0);
+				}
+				Speed = Token;  // Get speed
+			}
+		}
+
+		if (!Speed.Len)  // Check for a speed value
+		{
+			if (cnt)
+				fprintf(Msg,"ERROR: No speed in command in line %d\n\n",cnt);
+			return (0);
+		}
+
+		// Needed speed command, output duplicates
+		PutStr(&Out,CODES[Code]);
+		PutChar(&Out,' ');
+		PutSpan(&Out,Speed.Ptr,Speed.Len);
+		PutTools<Heads>(&Out,Out.Start);
+		break;
+	case M82:  // 'E' mode changes, the line stays as it is
+	case G90:
+		RelativeE = 0;
+		break;
+	case M83:
+	case G91:
+		RelativeE = 1;
+		break;
+	case G92:  // Set position, the added extruders are set to where their
+			// 'E' would be, so the ratio carries on from the first 'E'
+	case G1:  // Coordinated Motion
+		Relative = RelativeE && G1 == Code;
+		PutStr(&Out,CODES[Code]);  // Start command
+
+		// Check for parameters
+		while (NextToken(&Parse,&Token))
+		{ // Got one!
+			if (Room - (size_t) (Out.Cur - Out.Start) < (Token.Len + MAXWORD) * (Heads - 1))
+				return (-1);  // Might not fit
+
+			// The following is derived from "Dual Extrude Both Extruders at Once for Replicator"
+			// from user thorstadg on thingiverse.com
+			if ('E' == Token.Letter || 'A' == Token.Letter || 'B' == Token.Letter)  // Check for 'E', 'A' or 'B'
+			{
+				if (Token.Len > 15)  // Check for parameter that fits in buffer
+				{
+					if (cnt)
+						fprintf(Msg,"ERROR: E Parameter too long in line %d\n\n",cnt);
+					return (0);
+				}
+
+				// Get current 'E' value
+				PROF_START(PROF_EREWRITE);
+				CurrentE = ParseE(Token.Num,Token.NumLen);
+				++EWords;
+
+/* Commented out to allow for retract on first/early moves
+				if (CurrentE < FirstE)  // Check for errors
+				{
+					fprintf(Msg,"ERROR: E Parameter direction error in line %d\n\n",cnt);
+					return (0);
+				}
+*/
+
+				if (FirstE > 0 || Relative) // Did we see an 'E' before, or is it a distance?
+				{  // Yes, figure new values for the added extruders
+					++Rewrites;
+					Base = Relative ? 0 : FirstE;
+
+					for (n = 0; n < Heads - 1; ++n)
+					{
+						NewE[n] = ((CurrentE - Base) * Ratio[n]) + Base;
+
+						// Round to the nearest .001, in .00001 units
+						NewE[n] = floor((NewE[n] * 100000.0) + 0.5);
+					}
+					PROF_END(PROF_EREWRITE);
+
+					// Replace with A/B/.., the new ones first
+					PROF_START(PROF_FORMAT);
+					for (n = 0; n < Heads - 1; ++n)
+					{
+						Head = n + (n >= Used);  // Skip the used one
+						PutChar(&Out,' ');
+						PutChar(&Out,(char) ('A' + Head));
+						PutFixed(&Out,NewE[n]);
+					}
+					PutChar(&Out,' ');
+					PutChar(&Out,(char) ('A' + Used));
+					PutSpan(&Out,Token.Num,Token.NumLen);
+					PROF_END(PROF_FORMAT);
+				}
+				else
+				{  // No, just output what we got, and save the first 'E'
+					FirstE = CurrentE; // Save first one
+					PROF_END(PROF_EREWRITE);
+
+					// Replace with A/B/..
+					PROF_START(PROF_FORMAT);
+					for (Head = 0; Head < Heads; ++Head)
+					{
+						PutChar(&Out,' ');
+						PutChar(&Out,(char) ('A' + Head));
+						PutSpan(&Out,Token.Num,Token.NumLen);
+					}
+					PROF_END(PROF_FORMAT);
+				}
+			}
+			else  // Just output
+			{
+				PutChar(&Out,' ');
+				PutSpan(&Out,Token.Ptr,Token.Len);
+			}
+		}
+		PutChar(&Out,'\012');
+
+		if (G92 == Code && !EWords)  // Doesn't set 'E', leave it as it was
+			Out.Cur = Out.Start;
+		break;
+	}
+
+	*OutLen = (size_t) (Out.Cur - Out.Start);
+
+	// Count it, now that it won't be done again
+	if (Code >= 0)
+		++Stats.Codes[Code];
+	Stats.Rewrites += Rewrites;
+
+	return (1);
+}
+
+// PutTools() Function
+//   Ends a duplicated command with the last
+//   toolhead, then repeats it for the others
+//   down to T0.
+//
+// Inputs: Out - Line being built, after the command
+//         Cmd - Start of the command in Out
+//
+template <int Heads>
+void PutTools(OutLine *Out, const char *Cmd)
+{
+	size_t Len = (size_t) (Out->Cur - Cmd);  // Command without the toolhead
+	int Head;
+
+	PutSpan(Out,TOOLS[Heads - 1],4);
+	for (Head = Heads - 2; Head >= 0; --Head)
+	{
+		PutSpan(Out,Cmd,Len);
+		PutSpan(Out,TOOLS[Head],4);
+	}
+}
+
+// CheckFile() Function
+//   Reads single extruder input file
+//   and checks it to make sure one and
+//   only one extruder is used.
+//
+//   Sets RightUsed & Left Used globals
+//   as needed.
+//
+// Inputs: infile - File to convert
+//         From - Offset to start at, for --resume
+//         Hash - Gets the whole file added for --cache, NULL if not
+//
+// Outputs: Sucess/Failure
+//
+int CheckFile(char *infile, unsigned long long From, InHash *Hash)
+{
+	InFile in;  // Input file
+	int cnt = 0; // Line counter
+	const char *Line;  // Current input line
+	size_t Len;  // Length of the input line
+	size_t Hashed;  // Mapped input hashed up to here
+
+	// Open file
+	if (!OpenIn(&in,infile,UseReadThread ? OPEN_AHEAD : OPEN_MAP))
+	{
+		fprintf(Msg,"ERROR: Can't open input file: %s\n\n",infile);
+		return (0);
+	}
+	if (!SkipIn(&in,From))
+	{
+		CloseIn(&in);
+		fprintf(Msg,"ERROR: Input file doesn't match the checkpoint: %s\n\n",infile);
+		return (0);
+	}
+	Hashed = in.Pos;
+
+	// Loop thru file, or up to the toolhead for --quick-check
+	while (!(QuickCheck && (LeftUsed || RightUsed)) && ReadLine(&in,&Line,&Len))
+	{
+		++cnt;  // Increment line counter
+
+		// Read lines are only there until the next read
+		if (NULL != Hash && !in.Mapped)
+			HashAdd(Hash,Line,Len);
+
+		if (!CheckLine(Line,Len))
+		{
+			fprintf(Msg,ERROR_BOTH);
+			CloseIn(&in);
+			return (0);
+		}
+
+		// Skip the lines after it without a command to check
+		cnt += ReadSpan(&in,&Line,&Len,1);
+
+		if (NULL != Hash && !in.Mapped)
+			HashAdd(Hash,Line,Len);
+		else if (NULL != Hash && in.Pos - Hashed >= HASHBLOCK)
+		{  // Mapped, hash what was checked while it's still in the CPU cache
+			HashAdd(Hash,in.Data + Hashed,in.Pos - Hashed);
+			Hashed = in.Pos;
+		}
+	}
+
+	// The hash needs what --quick-check didn't get to too
+	if (NULL != Hash && in.Mapped)
+		HashAdd(Hash,in.Data + Hashed,in.Size - Hashed);
+	else if (NULL != Hash)
+	{
+		while (ReadLine(&in,&Line,&Len))
+			HashAdd(Hash,Line,Len);
+	}
+	if (in.Failed)
+	{
+		fprintf(Msg,"ERROR: Can't read input file: %s\n\n",infile);
+		CloseIn(&in);
+		return (0);
+	}
+
+	// Close flle
+	CloseIn(&in);
+
+	// Check to see if we found one
+	if (!RightUsed && !LeftUsed)
+	{
+		fprintf(Msg,"ERROR: Couldn't find a used extruder!\n\n");
+		return (0);
+	}
+
+	if (QuickCheck)
+		fprintf(Msg,"%d Lines checked, the rest will be checked while converting...\n",cnt);
+	else
+		fprintf(Msg,"%d Lines checked...\n",cnt);
+
+	return (1);
+}
+
+// CheckLine() Function
+//   Checks one line for a command that
+//   tells us which toolhead is active.
+//
+//   Sets RightUsed & Left Used globals
+//   as needed.
+//
+// Inputs: Line - Line to check
+//         Len - Length of the line
+//
+// Outputs: Sucess/Failure if both are used, the caller
+//          shows ERROR_BOTH. ConvLine() may not want it shown.
+//
+int CheckLine(const char *Line, size_t Len)
+{
+	GLine Parse;  // Line being parsed
+	GToken Token;  // Next token
+	int UsedLeft, UsedRight, Temp;
+
+	StartLine(&Parse,Line,Len);
+	if (!NextToken(&Parse,&Token))  // Check for no tokens
+		return (1);
+
+	// Look for a command that will tell us which toolhead is active
+	switch (CheckCode(&Token))
+	{
+	case M101:  // On commands
+	case M102:
+		// Check for parameters
+		if (NextToken(&Parse,&Token))
+		{
+			if (TokenIs(&Token,"T0")) // Check for Right extruder
+			{
+				if (LeftUsed)  // Both used
+					return (0);
+				RightUsed = 1;
+				break;
+			}
+			if (TokenIs(&Token,"T1")) // Check for Left extruder
+			{
+				if (RightUsed)  // Both used
+					return (0);
+				LeftUsed = 1;
+				break;
+			}
+		}
+		break;
+	case M104:  // Temp command
+		UsedLeft = 0;
+		UsedRight = 0;
+		Temp = 0;
+		// Check for parameters
+		while (NextToken(&Parse,&Token))
+		{
+			if (TokenIs(&Token,"T0")) // Check for Right extruder
+				UsedRight = 1;
+
+			if (TokenIs(&Token,"T1")) // Check for Left extruder
+				UsedLeft = 1;
+
+			if ('S' == Token.Letter)  // Check for temp value
+				ParseInt(Token.Num,Token.NumLen,&Temp);
+		}
+
+		// Check for right extruder active
+		if (UsedRight && Temp > 0)
+		{
+			if (LeftUsed)  // Both used
+				return (0);
+			RightUsed = 1;
+			break;
+		}
+
+		// Check for left extruder active
+		if (UsedLeft && Temp > 0)
+		{
+			if (RightUsed)  // Both used
+				return (0);
+			LeftUsed = 1;
+			break;
+		}
+		break;
+	}
+
+	return (1);
+}
+
+// CheckCode() Function
+//   Checks a token to see if it
+//   matches one of the known G/M codes.
+//
+//   The letter and number are decoded and looked
+//   up with a switch, so the cost doesn't depend
+//   on how many codes we know about.
+//
+// Inputs: Token - Token to check
+//
+// Outputs: Code ID, or NOTOKENS if none found
+//
+int CheckCode(const GToken *Token)
+{
+	const char *p = Token->Num;
+	const char *End = Token->Num + Token->NumLen;
+	int Num = 0;  // Code number
+
+	// Must be all digits, written the same way as in CODES
+	if (Token->NumLen < 1 || Token->NumLen > 3 || (Token->NumLen > 1 && '0' == *p))
+		return (NOTOKENS);
+	for (; p < End; ++p)
+	{
+		if (*p < '0' || *p > '9')
+			return (NOTOKENS);
+		Num = (Num * 10) + (*p - '0');
+	}
+
+	switch (Token->Letter)
+	{
+	case 'G':  // G codes
+		switch (Num)
+		{
+		case 1: return (G1);
+		case 90: return (G90);
+		case 91: return (G91);
+		case 92: return (G92);
+		}
+		break;
+	case 'M':  // M codes
+		switch (Num)
+		{
+		case 6: return (M6);
+		case 82: return (M82);
+		case 83: return (M83);
+		case 101: return (M101);
+		case 102: return (M102);
+		case 103: return (M103);
+		case 104: return (M104);
+		case 108: return (M108);
+		}
+		break;
+	}
+
+	return (NOTOKENS);
+}
+
+// StartLine() Function
+//   Sets up a line for NextToken().
+//
+// Inputs: Parse - Parse state to set up
+//         Line - Line to parse, not changed
+//         Len - Length of the line
+//
+void StartLine(GLine *Parse, const char *Line, size_t Len)
+{
+	Parse->Cur = Line;
+	Parse->End = Line + Len;
+}
+
+// NextToken() Function
+//   Finds the next space or end of line
+//   separated word in a line, the same
+//   words strtok() would find.
+//
+// Inputs: Parse - Line being parsed
+//         Token - Set to the word found
+//
+// Outputs: 1 if a word was found, 0 at the end of the line
+//
+int NextToken(GLine *Parse, GToken *Token)
+{
+	const char *p = Parse->Cur;
+
+	// Skip separators
+	while (p < Parse->End && (' ' == *p || '\012' == *p))
+		++p;
+
+	if (p >= Parse->End)  // Check for end of line
+	{
+		Parse->Cur = p;
+		return (0);
+	}
+
+	// Find the end of the word
+	Token->Ptr = p;
+	while (p < Parse->End && ' ' != *p && '\012' != *p)
+		++p;
+	Token->Len = (size_t) (p - Token->Ptr);
+
+	// Split off the letter
+	Token->Letter = Token->Ptr[0];
+	Token->Num = Token->Ptr + 1;
+	Token->NumLen = Token->Len - 1;
+
+	Parse->Cur = p;
+	return (1);
+}
+
+// TokenIs() Function
+//   Compares a token to a string.
+//
+// Inputs: Token - Token to check
+//         Str - String to compare with
+//
+// Outputs: 1 if they match
+//
+int TokenIs(const GToken *Token, const char *Str)
+{
+	return (!strncmp(Token->Ptr,Str,Token->Len) && 0 == Str[Token->Len]);
+}
+
+// ParseInt() Function
+//   Reads an integer from part of a token
+//   the same way sscanf("%d") would.
+//
+//   Like strtol(), values too big for a long
+//   stop at LONG_MAX/LONG_MIN, and that is cut
+//   down to an int the way glibc's "%d" does.
+//
+// Inputs: p - Start of the number
+//         Len - Chars available
+//         Val - Set to the number, unchanged if there isn't one
+//
+// Outputs: 1 if a number was found
+//
+int ParseInt(const char *p, size_t Len, int *Val)
+{
+	const char *End = p + Len;
+	int Neg = 0;
+	int Got = 0;
+	unsigned long long Result = 0;
+	unsigned long long Limit;  // Biggest the digits can be
+
+	// Skip white space, optional sign
+	while (p < End && ('\t' == *p || '\r' == *p || '\v' == *p || '\f' == *p))
+		++p;
+	if (p < End && ('-' == *p || '+' == *p))
+		Neg = ('-' == *p++);
+
+	// Get digits, staying at the limit once past it
+	Limit = Neg ? (unsigned long long) LONG_MAX + 1 : (unsigned long long) LONG_MAX;
+	for (; p < End && *p >= '0' && *p <= '9'; ++p, Got = 1)
+	{
+		if (Result > (Limit - (unsigned long long) (*p - '0')) / 10)
+			Result = Limit;
+		else
+			Result = (Result * 10) + (unsigned long long) (*p - '0');
+	}
+
+	if (Got)
+		*Val = (int) (Neg ? (long) (0 - Result) : (long) Result);
+
+	return (Got);
+}
+
+// ParseE() Function
+//   Reads an 'E' value the same way strtod() would.
+//
+//   Plain decimal values of up to 15 chars are
+//   exact as an integer and a power of ten, so
+//   one divide gives the same double strtod()
+//   does. Anything else, longer values too, is
+//   left to strtod().
+//
+// Inputs: p - Start of the value
+//         Len - Chars available
+//
+// Outputs: Value, 0 if there isn't one
+//
+double ParseE(const char *p, size_t Len)
+{
+	static const double Pow10[16] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7,
+		1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15 };
+	const char *Start = p;
+	const char *End = p + Len;
+	char Num[PARSELEN + 1];  // Value as a string for strtod()
+	unsigned long long Mant = 0;  // Digits as an integer
+	int Places = -1;  // Digits after the '.', -1 before the '.'
+	int Neg = 0;
+	int Got = 0;
+	double Val;
+
+	// Optional sign
+	if (p < End && ('-' == *p || '+' == *p))
+		Neg = ('-' == *p++);
+
+	// Digits with an optional '.'
+	for (; p < End; ++p)
+	{
+		if (*p >= '0' && *p <= '9')
+		{
+			Mant = (Mant * 10) + (unsigned long long) (*p - '0');
+			Got = 1;
+			if (Places >= 0)
+				++Places;
+		}
+		else if ('.' == *p && Places < 0)
+			Places = 0;
+		else
+			break;
+	}
+
+	// Exponents, hex, inf/nan, leading white space or too long
+	// to be exact, let strtod() have it
+	if (Len > 15 || (p < End && (p == Start || (*p >= 'a' && *p <= 'z') || (*p >= 'A' && *p <= 'Z'))))
+	{
+		if (Len > PARSELEN)
+			Len = PARSELEN;
+		memcpy(Num,Start,Len);
+		Num[Len] = 0;
+		return (strtod(Num,NULL));
+	}
+
+	if (!Got)  // No number
+		return (0.0);
+
+	Val = (double) Mant;
+	if (Places > 0)
+		Val = Val / Pow10[Places];
+
+	return (Neg ? -Val : Val);
+}
+
+// ParseFixed() Function
+//   Reads a plain decimal value as a
+//   fixed point number, exactly.
+//
+// Inputs: p - Start of the value
+//         Len - Chars available
+//         Places - Decimal places in the number
+//         Val - Set to the value times 10^Places
+//
+// Outputs: 1 if the value fits, 0 if it has exponents, too
+//          many decimal places, too many digits or other chars
+//
+int ParseFixed(const char *p, size_t Len, int Places, long long *Val)
+{
+	const char *End = p + Len;
+	int Neg = 0;
+	int Digits = 0;  // Digits used
+	int Frac = -1;  // Decimal places, -1 before the '.'
+	long long Result = 0;
+
+	if (p < End && ('-' == *p || '+' == *p))
+		Neg = ('-' == *p++);
+
+	for (; p < End; ++p)
+	{
+		if ('.' == *p && Frac < 0)
+			Frac = 0;
+		else if (*p >= '0' && *p <= '9' && Digits < 17 && Frac < Places)
+		{
+			Result = (Result * 10) + (*p - '0');
+			++Digits;
+			if (Frac >= 0)
+				++Frac;
+		}
+		else
+			return (0);
+	}
+	if (!Digits)
+		return (0);
+
+	for (Frac = Frac < 0 ? 0 : Frac; Frac < Places; ++Frac)
+		Result *= 10;
+
+	*Val = Neg ? -Result : Result;
+
+	return (1);
+}
+
+// StartOut() / Put*() Functions
+//   Build a new line in a buffer,
+//   keeping track of where we are.
+//
+// Inputs: Out - Line being built
+//         buf/Str/Val - What to add
+//
+void StartOut(OutLine *Out, char *buf)
+{
+	Out->Start = buf;
+	Out->Cur = buf;
+}
+
+void PutSpan(OutLine *Out, const char *Str, size_t Len)
+{
+	memcpy(Out->Cur,Str,Len);
+	Out->Cur += Len;
+}
+
+void PutStr(OutLine *Out, const char *Str)
+{
+	PutSpan(Out,Str,strlen(Str));
+}
+
+void PutChar(OutLine *Out, char c)
+{
+	*Out->Cur++ = c;
+}
+
+void PutInt(OutLine *Out, int Val)
+{
+	if (Val < 0)
+	{
+		PutChar(Out,'-');
+		PutDigits(Out,0ULL - (unsigned long long) Val,1);
+	}
+	else
+		PutDigits(Out,(unsigned long long) Val,1);
+}
+
+// Outputs at least Min digits, with leading zeros
+void PutDigits(OutLine *Out, unsigned long long Val, int Min)
+{
+	char Digits[24];  // Digits, backwards
+	int cnt = 0;
+
+	do {
+		Digits[cnt++] = (char) ('0' + (Val % 10));
+		Val /= 10;
+	} while (Val || cnt < Min);
+
+	while (cnt)
+		*Out->Cur++ = Digits[--cnt];
+}
+
+// Outputs a count of .00001 units the same way
+// printf("%.5f") would output Units / 100000.0
+void PutFixed(OutLine *Out, double Units)
+{
+	unsigned long long Val;
+
+	// Past 2^52 units the divide could round differently,
+	// nan and inf too, so let printf() do those
+	if (!(fabs(Units) < 4503599627370496.0))
+	{
+		Out->Cur += sprintf(Out->Cur,"%.5f",Units / 100000.0);
+		return;
+	}
+
+	if (Units < 0)
+	{
+		PutChar(Out,'-');
+		Val = (unsigned long long) -Units;
+	}
+	else
+		Val = (unsigned long long) Units;
+
+	PutDigits(Out,Val / 100000,1);
+	PutChar(Out,'.');
+	PutDigits(Out,Val % 100000,5);
+}
+
+// OpenIn() Function
+//   Opens an input file for ReadLine().
+//   Regular files are mapped into memory,
+//   anything else is read in blocks.
+//   gzip and zstd files are decompressed
+//   on their own thread.
+//
+// Inputs: in - Input file to set up
+//         infile - Name of the file to open
+//         How - OPEN_MAP, OPEN_AHEAD to read it in blocks on its own
+//               thread, or OPEN_LINES to take input as it arrives
+//
+// Outputs: Sucess/Failure
+//
+int OpenIn(InFile *in, const char *infile, int How)
+{
+	int Type;  // Compression used
+
+	memset(in,0,sizeof(*in));
+
+#ifndef _WIN32
+	int fd;  // File descriptor for mapping
+	struct stat st;  // File info
+	void *Map;  // Mapped file
+
+	if (!strcmp(infile,"-"))  // stdin
+		fd = dup(fileno(stdin));
+	else
+		fd = open(infile,O_RDONLY);
+	if (fd < 0)
+		return (0);
+
+	// Map it if it's a normal file, empty files can't be mapped
+	if (OPEN_AHEAD != How && !fstat(fd,&st) && S_ISREG(st.st_mode) && st.st_size > 0 && 0 == lseek(fd,0,SEEK_CUR))
+	{
+		Map = mmap(NULL,(size_t) st.st_size,PROT_READ,MAP_PRIVATE,fd,0);
+		if (MAP_FAILED != Map)
+		{
+			madvise(Map,(size_t) st.st_size,MADV_SEQUENTIAL);
+
+			// Compressed files are decompressed from the mapping
+			if (ZIP_NONE != (Type = ZipType((const char *) Map,(size_t) st.st_size)))
+			{
+				close(fd);
+				return (OpenZip(in,Type,NULL,(const char *) Map,(size_t) st.st_size));
+			}
+
+			in->Data = (char *) Map;
+			in->Size = (size_t) st.st_size;
+			in->Mapped = 1;
+			in->fd = fd;
+			return (1);
+		}
+	}
+	close(fd);
+#endif
+
+	// Fall back to reading it in blocks
+	// Text mode would garble compressed files on Windows,
+	// so look at the start in binary mode first
+	if (!strcmp(infile,"-"))
+		in->fp = stdin;
+#ifdef _WIN32
+	else if ((in->fp = fopen(infile,"rb")) == NULL)
+#else
+	else if ((in->fp = fopen(infile,"r")) == NULL)
+#endif
+		return (0);
+
+	in->Alloc = BLOCKSIZE;
+	if ((in->Data = (char *) malloc(BLOCKSIZE)) == NULL)
+	{
+		if (stdin != in->fp)
+			fclose(in->fp);
+		in->fp = NULL;
+		return (0);
+	}
+
+	// Waiting for a whole block would hold up the first
+	// lines, so only plain text can be streamed
+	if (OPEN_LINES == How)
+	{
+		in->ByLine = 1;
+		return (1);
+	}
+
+	// Read the first block to see if it's compressed
+	in->Size = fread(in->Data,1,BLOCKSIZE,in->fp);
+	if (ZIP_NONE != (Type = ZipType(in->Data,in->Size)))
+		return (OpenZip(in,Type,in->fp,NULL,0));
+
+#ifdef _WIN32
+	// Plain text, start again in text mode
+	if (stdin != in->fp)
+	{
+		if ((in->fp = freopen(infile,"r",in->fp)) == NULL)
+		{
+			free(in->Data);
+			memset(in,0,sizeof(*in));
+			return (0);
+		}
+		in->Size = fread(in->Data,1,BLOCKSIZE,in->fp);
+	}
+#endif
+
+	if (ferror(in->fp))
+		in->Failed = 1;
+	else if (!in->Size)
+		in->Eof = 1;
+	else if (OPEN_AHEAD == How && BLOCKSIZE == in->Size)  // Read the rest ahead
+		return (OpenZip(in,ZIP_NONE,in->fp,NULL,0));
+
+	return (1);
+}
+
+// ReadLine() Function
+//   Gets the next line from an input file,
+//   without copying it. Lines can be any length,
+//   the read buffer grows to hold the longest one.
+//
+// Inputs: in - Input file, Failed set if out of memory
+//         Line - Set to the start of the line
+//         Len - Set to the length of the line, including the '\n'
+//
+// Outputs: 1 if a line was found, 0 at the end of the file
+//
+// The line is only valid until the next call.
+//
+int ReadLine(InFile *in, const char **Line, size_t *Len)
+{
+	char *End;  // End of line character
+	size_t Scan = in->Pos;  // Where to look for it
+	size_t Left;  // Bytes in the partial line
+	size_t Got;  // Bytes read
+	char *NewData;
+	double Wait;  // For --stats
+
+	// Find the end of the line, reading more until there is one
+	PROF_START(PROF_READ);
+	while (NULL == (End = (char *) memchr(in->Data + Scan,'\012',in->Size - Scan)))
+	{
+		Scan = in->Size;
+		if ((NULL == in->fp && NULL == in->Zip) || in->Eof)
+			break;
+
+		// Move the partial line to the front, or make room for more of it
+		Left = in->Size - in->Pos;
+		if (in->Pos)
+		{
+			memmove(in->Data,in->Data + in->Pos,Left);
+			Scan -= in->Pos;
+			in->Base += in->Pos;
+			in->Pos = 0;
+		}
+		else if (Left == in->Alloc)
+		{
+			if (NULL == (NewData = (char *) realloc(in->Data,in->Alloc * 2)))
+			{
+				in->Failed = 1;
+				PROF_END(PROF_READ);
+				return (0);
+			}
+			in->Data = NewData;
+			in->Alloc *= 2;
+		}
+
+		Wait = ShowStats ? GetTime() : 0;
+		Got = ReadIn(in,in->Data + Left,in->Alloc - Left);
+		if (ShowStats)
+			Stats.IoWait += GetTime() - Wait;
+		in->Size = Left + Got;
+		if (!Got)
+			in->Eof = 1;
+	}
+
+	PROF_END(PROF_READ);
+	if (in->Pos >= in->Size)  // Check for end of file
+		return (0);
+
+	*Line = in->Data + in->Pos;
+	if (NULL != End)
+		*Len = (size_t) (End - *Line) + 1;
+	else  // Last line without a '\n'
+		*Len = in->Size - in->Pos;
+	in->Pos += *Len;
+
+	return (1);
+}
+
+// LineReady() Function
+//   Checks if ReadLine() has a whole line
+//   without reading more.
+//
+// Inputs: in - Input file
+//
+// Outputs: 1 if a line is there, 0 if ReadLine() would have to wait
+//
+int LineReady(const InFile *in)
+{
+	if (NULL == in->fp && NULL == in->Zip)  // Mapped, it's all there
+		return (1);
+
+	return (in->Pos < in->Size && NULL != memchr(in->Data + in->Pos,'\012',in->Size - in->Pos));
+}
+
+// ReadSpan() Function
+//   Takes the lines after the last one read
+//   that ConvLine() wouldn't change, so they
+//   can be copied as they are. Only looks at
+//   what is already in the buffer.
+//
+// Inputs: in - Input file, at the start of a line
+//         Span - Set to the first line
+//         Len - Set to the length of the lines
+//         CheckOnly - Only stop at lines CheckLine() looks at
+//
+// Outputs: Lines taken, 0 if the next one is needed
+//
+int ReadSpan(InFile *in, const char **Span, size_t *Len, int CheckOnly)
+{
+	int Lines = 0;
+
+	*Span = in->Data + in->Pos;
+	*Len = ScanSpan(*Span,in->Data + in->Size,CheckOnly,&Lines);
+	in->Pos += *Len;
+
+	return (Lines);
+}
+
+// ScanSpan() Function
+//   Finds the whole lines at the start of some
+//   data whose first word CheckCode() doesn't
+//   know, which ConvLine() copies unchanged.
+//
+//   The data is scanned a SCANBLOCK at a time
+//   for '\n's and for line starts with a space,
+//   'G' or 'M', which are the only lines that
+//   need their first word looked at. Comments and
+//   most other lines are skipped without that.
+//
+// Inputs: p - Start of a line
+//         End - End of the data
+//         CheckOnly - Only stop at lines CheckLine() looks at,
+//                     so G lines don't need a look either
+//         Lines - Set to the number of lines found
+//
+// Outputs: Bytes in the lines found
+//
+size_t ScanSpan(const char *p, const char *End, int CheckOnly, int *Lines)
+{
+	const char *Cur;  // Block being scanned
+	const char *Last = p;  // End of the last whole line
+	char Tail[SCANBLOCK];  // Last part block, padded out
+	unsigned long long Ends;  // '\n's in the block
+	unsigned long long Starts;  // Spaces and 'M's in the block
+	unsigned long long Gs;  // 'G's in the block
+	unsigned long long Check;  // Lines to look at closer
+	unsigned long long First = 1;  // Block starts a line
+	int Pos;
+	int n = 0;  // Lines so far
+
+	// Most of the time a G1 is next, so check for that first
+	if (!CheckOnly && End - p > 2 && 'G' == p[0] && '1' == p[1] && ' ' == p[2])
+	{
+		*Lines = 0;
+		return (0);
+	}
+
+	for (Cur = p; Cur < End; Cur += SCANBLOCK)
+	{
+		if (End - Cur >= SCANBLOCK)
+			ScanBlock(Cur,&Ends,&Starts,&Gs);
+		else
+		{
+			memset(Tail,0,SCANBLOCK);
+			memcpy(Tail,Cur,(size_t) (End - Cur));
+			ScanBlock(Tail,&Ends,&Starts,&Gs);
+		}
+		if (!CheckOnly)
+			Starts |= Gs;
+
+		// Line starts that might be a command
+		for (Check = ((Ends << 1) | First) & Starts; Check; Check &= Check - 1)
+		{
+			Pos = LowBit(Check);
+			if (SpanStop(Cur + Pos,End,CheckOnly))
+			{
+				*Lines = n + CountBits(Ends & ((1ULL << Pos) - 1));
+				return ((size_t) (Cur + Pos - p));
+			}
+		}
+
+		if (Ends)
+		{
+			n += CountBits(Ends);
+			Last = Cur + HighBit(Ends) + 1;
+		}
+		First = Ends >> (SCANBLOCK - 1);
+	}
+
+	*Lines = n;
+	return ((size_t) (Last - p));
+}
+
+// SpanStop() Function
+//   Checks if ScanSpan() has to stop at a line,
+//   because ConvLine() might change it.
+//
+// Inputs: Line - Start of the line
+//         End - End of the data
+//         CheckOnly - Only stop for codes CheckLine() looks at
+//
+// Outputs: 1 if the first word is a code we need,
+//          or isn't all there yet
+//
+int SpanStop(const char *Line, const char *End, int CheckOnly)
+{
+	GToken Token;  // First word
+	const char *p = Line;
+	int Code;
+
+	// Skip spaces, a line of only spaces is copied
+	while (p < End && ' ' == *p)
+		++p;
+	if (p < End && '\012' == *p)
+		return (0);
+
+	// Find the end of the word, the same as NextToken()
+	Token.Ptr = p;
+	while (p < End && ' ' != *p && '\012' != *p)
+		++p;
+	if (p >= End)
+		return (1);
+
+	Token.Len = (size_t) (p - Token.Ptr);
+	Token.Letter = Token.Ptr[0];
+	Token.Num = Token.Ptr + 1;
+	Token.NumLen = Token.Len - 1;
+	Code = CheckCode(&Token);
+
+	if (CheckOnly)
+		return (M101 == Code || M102 == Code || M104 == Code);
+	return (NOTOKENS != Code);
+}
+
+// ScanScalar() Function
+//   Finds the '\n's, spaces, 'M's and 'G's
+//   in a SCANBLOCK, 8 bytes at a time.
+//
+// Inputs: p - Block to scan
+//         Ends - Set to a bit for each '\n'
+//         Starts - Set to a bit for each space or 'M'
+//         Gs - Set to a bit for each 'G'
+//
+void ScanScalar(const char *p, unsigned long long *Ends, unsigned long long *Starts, unsigned long long *Gs)
+{
+	unsigned long long Word;  // Next 8 bytes, first one in the low bits
+	int i;
+
+	*Ends = 0;
+	*Starts = 0;
+	*Gs = 0;
+	for (i = 0; i < SCANBLOCK; i += 8)
+	{
+		memcpy(&Word,p + i,8);
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+		Word = __builtin_bswap64(Word);
+#endif
+		*Ends |= ByteMask(Word,'\012') << i;
+		*Starts |= (ByteMask(Word,' ') | ByteMask(Word,'M')) << i;
+		*Gs |= ByteMask(Word,'G') << i;
+	}
+}
+
+// ByteMask() Function
+//   Finds the bytes in a word that match a char.
+//
+// Inputs: Word - 8 bytes
+//         c - Char to look for
+//
+// Outputs: A bit for each matching byte, bit 0 for the low byte
+//
+unsigned long long ByteMask(unsigned long long Word, char c)
+{
+	const unsigned long long Low7 = 0x7f7f7f7f7f7f7f7fULL;
+
+	// Matching bytes become 0, then get their high bit set
+	Word ^= 0x0101010101010101ULL * (unsigned char) c;
+	Word = ~(((Word & Low7) + Low7) | Word | Low7);
+
+	// Gather the high bits into the top byte
+	return (((Word >> 7) * 0x0102040810204080ULL) >> 56);
+}
+
+#ifdef SCAN_AVX2
+// ScanAvx2() Function
+//   Same as ScanScalar(), 32 bytes at a time
+//   with AVX2. Only used if the CPU has it.
+//
+// Inputs: p - Block to scan
+//         Ends - Set to a bit for each '\n'
+//         Starts - Set to a bit for each space or 'M'
+//         Gs - Set to a bit for each 'G'
+//
+__attribute__((target("avx2")))
+void ScanAvx2(const char *p, unsigned long long *Ends, unsigned long long *Starts, unsigned long long *Gs)
+{
+	const __m256i Nl = _mm256_set1_epi8('\012');
+	const __m256i Sp = _mm256_set1_epi8(' ');
+	const __m256i M = _mm256_set1_epi8('M');
+	const __m256i G = _mm256_set1_epi8('G');
+	__m256i In;
+	unsigned long long Half[2][3];  // Masks for each half
+	int i;
+
+	for (i = 0; i < 2; ++i)
+	{
+		In = _mm256_loadu_si256((const __m256i *) (p + (i * 32)));
+		Half[i][0] = (unsigned int) _mm256_movemask_epi8(_mm256_cmpeq_epi8(In,Nl));
+		Half[i][1] = (unsigned int) _mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(In,Sp),
+			_mm256_cmpeq_epi8(In,M)));
+		Half[i][2] = (unsigned int) _mm256_movemask_epi8(_mm256_cmpeq_epi8(In,G));
+	}
+	*Ends = Half[0][0] | (Half[1][0] << 32);
+	*Starts = Half[0][1] | (Half[1][1] << 32);
+	*Gs = Half[0][2] | (Half[1][2] << 32);
+}
+#endif
+
+#ifdef SCAN_NEON
+// ScanNeon() Function
+//   Same as ScanScalar(), 16 bytes at a time
+//   with NEON.
+//
+// Inputs: p - Block to scan
+//         Ends - Set to a bit for each '\n'
+//         Starts - Set to a bit for each space or 'M'
+//         Gs - Set to a bit for each 'G'
+//
+void ScanNeon(const char *p, unsigned long long *Ends, unsigned long long *Starts, unsigned long long *Gs)
+{
+	const uint8x16_t Bits = { 1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128 };
+	uint8x16_t In, E[4], S[4], G[4];
+	int i;
+
+	// Keep a bit for each matching byte
+	for (i = 0; i < 4; ++i)
+	{
+		In = vld1q_u8((const uint8_t *) p + (i * 16));
+		E[i] = vandq_u8(vceqq_u8(In,vdupq_n_u8('\012')),Bits);
+		S[i] = vandq_u8(vorrq_u8(vceqq_u8(In,vdupq_n_u8(' ')),vceqq_u8(In,vdupq_n_u8('M'))),Bits);
+		G[i] = vandq_u8(vceqq_u8(In,vdupq_n_u8('G')),Bits);
+	}
+
+	// Add up neighbours until each byte holds the bits for 8 input bytes
+	E[0] = vpaddq_u8(vpaddq_u8(E[0],E[1]),vpaddq_u8(E[2],E[3]));
+	S[0] = vpaddq_u8(vpaddq_u8(S[0],S[1]),vpaddq_u8(S[2],S[3]));
+	G[0] = vpaddq_u8(vpaddq_u8(G[0],G[1]),vpaddq_u8(G[2],G[3]));
+	*Ends = vgetq_lane_u64(vreinterpretq_u64_u8(vpaddq_u8(E[0],E[0])),0);
+	*Starts = vgetq_lane_u64(vreinterpretq_u64_u8(vpaddq_u8(S[0],S[0])),0);
+	*Gs = vgetq_lane_u64(vreinterpretq_u64_u8(vpaddq_u8(G[0],G[0])),0);
+}
+#endif
+
+// PickScan() Function
+//   Picks the block scanner for ScanSpan(),
+//   AVX2 if this CPU has it.
+//
+// Outputs: Scanner to use
+//
+ScanFunc PickScan(void)
+{
+#if defined(SCAN_AVX2)
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2"))
+		return (ScanAvx2);
+#elif defined(SCAN_NEON)
+	return (ScanNeon);
+#endif
+	return (ScanScalar);
+}
+
+// CountBits() Function
+//   Counts the bits set in a mask.
+//
+// Inputs: Bits - Mask
+//
+// Outputs: Bits set
+//
+int CountBits(unsigned long long Bits)
+{
+#ifdef __GNUC__
+	return (__builtin_popcountll(Bits));
+#else
+	int n;
+
+	for (n = 0; Bits; Bits &= Bits - 1)
+		++n;
+	return (n);
+#endif
+}
+
+// LowBit() Function
+//   Finds the lowest bit set in a mask.
+//
+// Inputs: Bits - Mask, not 0
+//
+// Outputs: Bit number
+//
+int LowBit(unsigned long long Bits)
+{
+#ifdef __GNUC__
+	return (__builtin_ctzll(Bits));
+#else
+	int n;
+
+	for (n = 0; !(Bits & 1); Bits >>= 1)
+		++n;
+	return (n);
+#endif
+}
+
+// HighBit() Function
+//   Finds the highest bit set in a mask.
+//
+// Inputs: Bits - Mask, not 0
+//
+// Outputs: Bit number
+//
+int HighBit(unsigned long long Bits)
+{
+#ifdef __GNUC__
+	return (63 - __builtin_clzll(Bits));
+#else
+	int n;
+
+	for (n = 0; Bits >>= 1;)
+		++n;
+	return (n);
+#endif
+}
+
+// ReadIn() Function
+//   Fills part of the read buffer from the
+//   file, or from the decompress thread.
+//
+// Inputs: in - Input file, Failed set on errors
+//         Dest - Where the data goes
+//         Max - Bytes wanted
+//
+// Outputs: Bytes read, less than Max only at the end of the file
+//          or when ByLine is set, 0 only at the end
+//
+size_t ReadIn(InFile *in, char *Dest, size_t Max)
+{
+	InZip *Zip = in->Zip;
+	size_t Got = 0;  // Bytes copied
+	size_t Part;
+
+	if (NULL == Zip && in->ByLine)
+	{  // Just what's there, waiting only if there's nothing
+#ifdef _WIN32
+		int Ret = _read(_fileno(in->fp),Dest,(unsigned int) (Max > BLOCKSIZE ? BLOCKSIZE : Max));
+#else
+		ssize_t Ret;
+
+		while ((Ret = read(fileno(in->fp),Dest,Max)) < 0 && EINTR == errno)
+			;
+#endif
+		if (Ret < 0)
+		{
+			in->Failed = 1;
+			return (0);
+		}
+		return ((size_t) Ret);
+	}
+
+	if (NULL == Zip)
+	{
+		Got = fread(Dest,1,Max,in->fp);
+		if (Got < Max && ferror(in->fp))
+			in->Failed = 1;
+		return (Got);
+	}
+
+	while (Got < Max)
+	{
+		// Take what's left of the current block
+		if (Zip->BlockPos < Zip->BlockLen)
+		{
+			Part = Zip->BlockLen - Zip->BlockPos;
+			if (Part > Max - Got)
+				Part = Max - Got;
+			memcpy(Dest + Got,Zip->Block + Zip->BlockPos,Part);
+			Zip->BlockPos += Part;
+			Got += Part;
+			continue;
+		}
+
+		// Give this one back, and wait for the next one
+		if (NULL != Zip->Block)
+			RingDone(&Zip->Ring);
+		Zip->BlockPos = 0;
+		if (NULL == (Zip->Block = RingGet(&Zip->Ring,&Zip->BlockLen)))
+		{  // All done
+			if (Zip->Failed)
+				in->Failed = 1;
+			break;
+		}
+	}
+
+	return (Got);
+}
+
+// SkipIn() Function
+//   Skips to a line that starts at Pos.
+//
+// Inputs: in - Input file, at the start
+//         Pos - Offset to skip to
+//
+// Outputs: Sucess/Failure if Pos isn't the start of a line
+//
+int SkipIn(InFile *in, unsigned long long Pos)
+{
+	const char *Line = NULL;
+	size_t Len = 0;
+
+	if (!Pos)
+		return (1);
+
+	// Mapped files can go straight there
+	if (NULL == in->fp && NULL == in->Zip)
+	{
+		if (Pos > in->Size || '\012' != in->Data[Pos - 1])
+			return (0);
+		in->Pos = (size_t) Pos;
+		return (1);
+	}
+
+	while (in->Base + in->Pos < Pos && ReadLine(in,&Line,&Len))
+		;
+
+	return (in->Base + in->Pos == Pos && '\012' == Line[Len - 1] && !in->Failed);
+}
+
+// CloseIn() Function
+//   Closes an input file opened with OpenIn().
+//
+// Inputs: in - Input file
+//
+void CloseIn(InFile *in)
+{
+#ifndef _WIN32
+	if (in->Mapped)
+	{
+		munmap(in->Data,in->Size);
+		close(in->fd);
+	}
+#endif
+
+	if (NULL != in->Zip)
+	{
+		CloseZip(in->Zip);
+		free(in->Data);
+	}
+
+	if (NULL != in->fp)
+	{
+		if (stdin != in->fp)
+			fclose(in->fp);
+		free(in->Data);
+	}
+
+	memset(in,0,sizeof(*in));
+}
+
+// ZipType() Function
+//   Checks the start of a file for
+//   gzip or zstd magic numbers.
+//
+// Inputs: Data - Start of the file
+//         Len - Bytes available
+//
+// Outputs: ZIP_NONE, ZIP_GZ or ZIP_ZSTD
+//
+int ZipType(const char *Data, size_t Len)
+{
+	const unsigned char *p = (const unsigned char *) Data;
+
+	if (Len >= 2 && 0x1f == p[0] && 0x8b == p[1])
+		return (ZIP_GZ);
+
+	if (Len >= 4 && 0x28 == p[0] && 0xb5 == p[1] && 0x2f == p[2] && 0xfd == p[3])
+		return (ZIP_ZSTD);
+
+	return (ZIP_NONE);
+}
+
+// OpenZip() Function
+//   Sets up an input file to be decompressed,
+//   or read ahead, and starts the read thread.
+//
+// Inputs: in - Input file, for an unmapped file
+//              in->Data holds the first in->Size bytes,
+//              which a plain file keeps
+//         Type - ZIP_GZ, ZIP_ZSTD or ZIP_NONE
+//         fp - Compressed file, NULL if mapped
+//         Map - Mapped compressed file
+//         MapSize - Bytes in Map
+//
+// Outputs: Sucess/Failure, the file is closed on failure
+//
+int OpenZip(InFile *in, int Type, FILE *fp, const char *Map, size_t MapSize)
+{
+	InZip *Zip = new InZip;
+	int Ok = 1;
+
+	Zip->Type = Type;
+	Zip->fp = fp;
+	Zip->Map = Map;
+	Zip->MapSize = MapSize;
+	Zip->SrcBuf = NULL;
+	Zip->SrcPos = 0;
+	Zip->Ended = 0;
+	Zip->Failed = 0;
+	Zip->Block = NULL;
+	Zip->BlockLen = 0;
+	Zip->BlockPos = 0;
+	Ok = RingAlloc(&Zip->Ring,ZIPBLOCK);
+
+	if (ZIP_NONE == Type)
+	{  // Plain file, read on from the end of in->Data
+		Zip->Src = NULL;
+		Zip->SrcLen = 0;
+	}
+	else if (NULL != fp)
+	{  // Compressed data comes thru the block we already read
+		Zip->SrcBuf = in->Data;
+		Zip->Src = in->Data;
+		Zip->SrcLen = in->Size;
+	}
+	else
+	{
+		Zip->Src = Map;
+		Zip->SrcLen = MapSize;
+	}
+
+	// Start the decompressor
+	switch (Type)
+	{
+	case ZIP_GZ:
+#ifdef USE_ZLIB
+		memset(&Zip->Gz,0,sizeof(Zip->Gz));
+		Ok = (Z_OK == inflateInit2(&Zip->Gz,15 + 16));
+#else
+		fprintf(Msg,"ERROR: Input file is gzip compressed, this build doesn't support it\n");
+		Ok = 0;
+#endif
+		break;
+	case ZIP_ZSTD:
+#ifdef USE_ZSTD
+		Ok = (NULL != (Zip->Zs = ZSTD_createDStream()));
+		Zip->ZsHint = 1;
+#else
+		fprintf(Msg,"ERROR: Input file is zstd compressed, this build doesn't support it\n");
+		Ok = 0;
+#endif
+		break;
+	}
+
+	if (ZIP_NONE != Type)
+	{  // Decompressed data starts over in its own buffer
+		in->Data = (char *) malloc(BLOCKSIZE);
+		in->Size = 0;
+		in->Pos = 0;
+		in->Alloc = BLOCKSIZE;
+	}
+	if (NULL == in->Data)
+		Ok = 0;
+
+	if (!Ok)
+	{
+		free(in->Data);
+		CloseZip(Zip);
+		memset(in,0,sizeof(*in));
+		return (0);
+	}
+
+	in->fp = NULL;
+	in->Zip = Zip;
+	Zip->Reader = std::thread(ZipThread,Zip);
+
+	return (1);
+}
+
+// ZipThread() Function
+//   Decompresses or reads blocks for ReadIn()
+//   until the end of the file, or until
+//   CloseZip() stops it.
+//
+// Inputs: Zip - Decompressor
+//
+void ZipThread(InZip *Zip)
+{
+	char *buf;  // Block being filled
+	size_t Len;  // Bytes in it
+
+	// Wait for a free block, NULL when stopped
+	while (NULL != (buf = RingSpace(&Zip->Ring)))
+	{
+		Len = ZipFill(Zip,buf,ZIPBLOCK);
+		if (Len)  // Hand it over
+			RingPut(&Zip->Ring,Len);
+
+		if (!Len || Zip->Ended || Zip->Failed)
+			break;
+	}
+	RingEnd(&Zip->Ring);
+}
+
+// ZipSrc() Function
+//   Gets more compressed data, if the
+//   file isn't mapped.
+//
+// Inputs: Zip - Decompressor
+//
+// Outputs: Compressed bytes available
+//
+size_t ZipSrc(InZip *Zip)
+{
+	if (Zip->SrcPos == Zip->SrcLen && NULL != Zip->fp)
+	{
+		Zip->SrcLen = fread(Zip->SrcBuf,1,BLOCKSIZE,Zip->fp);
+		Zip->SrcPos = 0;
+		if (!Zip->SrcLen && ferror(Zip->fp))
+			Zip->Failed = 1;
+	}
+
+	return (Zip->SrcLen - Zip->SrcPos);
+}
+
+// ZipFill() Function
+//   Decompresses the next block.
+//
+// Inputs: Zip - Decompressor, Ended/Failed set at the end
+//         Dest - Where the data goes
+//         Max - Bytes wanted
+//
+// Outputs: Bytes decompressed
+//
+size_t ZipFill(InZip *Zip, char *Dest, size_t Max)
+{
+	size_t Avail;  // Compressed bytes available
+	size_t Got = 0;  // Bytes decompressed
+
+	if (ZIP_NONE == Zip->Type)
+	{  // Plain file, just read it
+		Got = fread(Dest,1,Max,Zip->fp);
+		if (Got < Max)
+		{
+			if (ferror(Zip->fp))
+				Zip->Failed = 1;
+			Zip->Ended = 1;
+		}
+		return (Got);
+	}
+
+#if !defined(USE_ZLIB) && !defined(USE_ZSTD)
+	(void) Dest;  // Built without either, OpenZip() doesn't get this far
+	(void) Max;
+	Zip->Failed = 1;
+#endif
+
+	while (Got < Max && !Zip->Ended && !Zip->Failed)
+	{
+		Avail = ZipSrc(Zip);
+		if (Avail > 0x40000000)  // zlib counts in 32 bits
+			Avail = 0x40000000;
+
+#ifdef USE_ZLIB
+		if (ZIP_GZ == Zip->Type)
+		{
+			int Ret;
+
+			if (!Avail)  // File ends in the middle
+			{
+				Zip->Failed = 1;
+				break;
+			}
+
+			Zip->Gz.next_in = (Bytef *) (Zip->Src + Zip->SrcPos);
+			Zip->Gz.avail_in = (uInt) Avail;
+			Zip->Gz.next_out = (Bytef *) (Dest + Got);
+			Zip->Gz.avail_out = (uInt) (Max - Got);
+
+			Ret = inflate(&Zip->Gz,Z_NO_FLUSH);
+			Zip->SrcPos += Avail - Zip->Gz.avail_in;
+			Got = Max - Zip->Gz.avail_out;
+
+			if (Z_STREAM_END == Ret)
+			{
+				if (ZipSrc(Zip))  // Another gzip member follows
+					inflateReset(&Zip->Gz);
+				else
+					Zip->Ended = 1;
+			}
+			else if (Z_OK != Ret && Z_BUF_ERROR != Ret)
+				Zip->Failed = 1;
+		}
+#endif
+
+#ifdef USE_ZSTD
+		if (ZIP_ZSTD == Zip->Type)
+		{
+			ZSTD_inBuffer In;  // Compressed data
+			ZSTD_outBuffer Out;  // Decompressed data
+			size_t Ret;
+
+			In.src = Zip->Src + Zip->SrcPos;
+			In.size = Avail;
+			In.pos = 0;
+			Out.dst = Dest;
+			Out.size = Max;
+			Out.pos = Got;
+
+			Ret = ZSTD_decompressStream(Zip->Zs,&Out,&In);
+			Zip->SrcPos += In.pos;
+
+			if (ZSTD_isError(Ret))
+				Zip->Failed = 1;
+			else if (!Avail && Out.pos == Got)
+			{  // Nothing more, done if the last frame was finished
+				if (Zip->ZsHint)
+					Zip->Failed = 1;
+				Zip->Ended = 1;
+			}
+			else
+				Zip->ZsHint = Ret;
+			Got = Out.pos;
+		}
+#endif
+	}
+
+	return (Got);
+}
+
+// CloseZip() Function
+//   Stops the decompress thread and
+//   frees the decompressor.
+//
+// Inputs: Zip - Decompressor
+//
+void CloseZip(InZip *Zip)
+{
+	if (Zip->Reader.joinable())
+	{
+		RingStop(&Zip->Ring);
+		Zip->Reader.join();
+	}
+
+#ifdef USE_ZLIB
+	if (ZIP_GZ == Zip->Type)
+		inflateEnd(&Zip->Gz);
+#endif
+#ifdef USE_ZSTD
+	if (ZIP_ZSTD == Zip->Type)
+		ZSTD_freeDStream(Zip->Zs);
+#endif
+
+#ifndef _WIN32
+	if (NULL != Zip->Map)
+		munmap((void *) Zip->Map,Zip->MapSize);
+#endif
+
+	if (NULL != Zip->fp)
+	{
+		if (stdin != Zip->fp)
+			fclose(Zip->fp);
+		free(Zip->SrcBuf);
+	}
+
+	RingRelease(&Zip->Ring);
+	delete Zip;
+}
+
+// RingAlloc() Function
+//   Sets up an empty ring and allocates
+//   its blocks.
+//
+// Inputs: Ring - Ring to set up
+//         Size - Bytes in each block
+//
+// Outputs: Sucess/Failure, RingRelease() frees what was allocated
+//
+int RingAlloc(BlockRing *Ring, size_t Size)
+{
+	int n;
+	int Ok = 1;
+
+	Ring->Size = Size;
+	Ring->Head = 0;
+	Ring->Tail = 0;
+	Ring->Done = 0;
+	Ring->Stop = 0;
+	Ring->Sleepers = 0;
+	for (n = 0; n < RINGSLOTS; ++n)
+	{
+		if (NULL == (Ring->Blocks[n] = (char *) malloc(Size)))
+			Ok = 0;
+	}
+
+	return (Ok);
+}
+
+// RingRelease() Function
+//   Frees a ring's blocks, once neither
+//   thread is using it.
+//
+// Inputs: Ring - Ring to free
+//
+void RingRelease(BlockRing *Ring)
+{
+	int n;
+
+	for (n = 0; n < RINGSLOTS; ++n)
+	{
+		free(Ring->Blocks[n]);
+		Ring->Blocks[n] = NULL;
+	}
+}
+
+// RingSpace() Function
+//   Gets the next block to fill, waiting
+//   for one to be used if they're all full.
+//
+// Inputs: Ring - Ring being filled
+//
+// Outputs: Block, NULL if RingStop() was called
+//
+char *RingSpace(BlockRing *Ring)
+{
+	RingWait(Ring,RING_ROOM);
+	if (Ring->Stop)
+		return (NULL);
+
+	return (Ring->Blocks[Ring->Head % RINGSLOTS]);
+}
+
+// RingPut() Function
+//   Passes the block from RingSpace() on
+//   to the thread using them.
+//
+// Inputs: Ring - Ring being filled
+//         Len - Bytes filled
+//
+void RingPut(BlockRing *Ring, size_t Len)
+{
+	unsigned Head = Ring->Head;
+
+	Ring->Lens[Head % RINGSLOTS] = Len;
+	Ring->Head = Head + 1;  // Lens is set before the block is seen
+	RingWake(Ring);
+}
+
+// RingEnd() Function
+//   Tells the thread using the blocks
+//   there won't be any more.
+//
+// Inputs: Ring - Ring being filled
+//
+void RingEnd(BlockRing *Ring)
+{
+	Ring->Done = 1;
+	RingWake(Ring);
+}
+
+// RingGet() Function
+//   Gets the next filled block, waiting
+//   for one if there aren't any yet.
+//
+// Inputs: Ring - Ring being used
+//         Len - Set to the bytes in the block
+//
+// Outputs: Block, NULL after the last one
+//
+char *RingGet(BlockRing *Ring, size_t *Len)
+{
+	unsigned Tail;
+
+	RingWait(Ring,RING_DATA);
+	Tail = Ring->Tail;
+	if (Ring->Head == Tail)  // Done, and all used
+	{
+		*Len = 0;
+		return (NULL);
+	}
+
+	*Len = Ring->Lens[Tail % RINGSLOTS];
+	return (Ring->Blocks[Tail % RINGSLOTS]);
+}
+
+// RingDone() Function
+//   Gives the block from RingGet() back
+//   to be filled again.
+//
+// Inputs: Ring - Ring being used
+//
+void RingDone(BlockRing *Ring)
+{
+	Ring->Tail = Ring->Tail + 1;
+	RingWake(Ring);
+}
+
+// RingStop() Function
+//   Tells the thread filling the blocks
+//   to stop, RingSpace() returns NULL.
+//
+// Inputs: Ring - Ring being used
+//
+void RingStop(BlockRing *Ring)
+{
+	Ring->Stop = 1;
+	RingWake(Ring);
+}
+
+// RingWait() Function
+//   Waits until a ring is ready for this
+//   thread. Usually it already is, and that
+//   only takes a look at the counters.
+//
+// Inputs: Ring - Ring to wait on
+//         Want - RING_ROOM, RING_DATA or RING_IDLE
+//
+void RingWait(BlockRing *Ring, int Want)
+{
+	if (RingReady(Ring,Want))
+		return;
+
+	// Sleep, the other thread wakes us if it sees Sleepers
+	// after its change, or we see the change here first
+	std::unique_lock<std::mutex> Guard(Ring->Lock);
+	++Ring->Sleepers;
+	while (!RingReady(Ring,Want))
+		Ring->Wake.wait(Guard);
+	--Ring->Sleepers;
+}
+
+// RingReady() Function
+//   Checks if a ring is ready for what
+//   a thread is waiting for.
+//
+// Inputs: Ring - Ring to check
+//         Want - RING_ROOM, RING_DATA or RING_IDLE
+//
+// Outputs: 1 if ready, 0 if it has to wait
+//
+int RingReady(BlockRing *Ring, int Want)
+{
+	unsigned Used = Ring->Head - Ring->Tail;  // Filled blocks not used yet
+
+	switch (Want)
+	{
+	case RING_ROOM:
+		return (Used < RINGSLOTS || Ring->Stop);
+	case RING_DATA:
+		return (Used > 0 || Ring->Done);
+	}
+
+	return (!Used);
+}
+
+// RingWake() Function
+//   Wakes the other thread after a change,
+//   if it's asleep in RingWait().
+//
+// Inputs: Ring - Ring that changed
+//
+void RingWake(BlockRing *Ring)
+{
+	if (Ring->Sleepers)
+	{
+		std::lock_guard<std::mutex> Guard(Ring->Lock);
+		Ring->Wake.notify_all();
+	}
+}
+
+// OpenOut() Function
+//   Creates the output file and its buffer(s),
+//   '-' is stdout.
+//
+// Inputs: outfile - Name of the file to create
+//         Keep - Bytes to keep from an existing file, for --resume
+//
+// Outputs: File, NULL on failure or if the file has less than Keep
+//
+OutFile *OpenOut(const char *outfile, unsigned long long Keep)
+{
+	int Zip = OutZip(outfile);  // Compress .gz/.zst files, on the write thread
+	OutFile *out = NewOut(OutBufSize,UseWriteThread || ZIP_NONE != Zip);
+
+	if (NULL == out)
+		return (NULL);
+	out->IsStdout = !strcmp(outfile,"-");
+	out->Written = out->Kept = out->Queued = Keep;
+	out->Zip = Zip;
+
+#ifdef _WIN32
+	if (out->IsStdout)
+	{
+		_setmode(_fileno(stdout),_O_BINARY);  // Same as "wb"
+		out->fp = stdout;
+	}
+	else if (Keep)
+	{  // Cut it back to Keep and add on from there
+		if (NULL != (out->fp = fopen(outfile,"r+b"))
+			&& (_fseeki64(out->fp,0,SEEK_END) || _ftelli64(out->fp) < (long long) Keep
+				|| _chsize_s(_fileno(out->fp),(long long) Keep) || _fseeki64(out->fp,(long long) Keep,SEEK_SET)))
+		{
+			fclose(out->fp);
+			out->fp = NULL;
+		}
+	}
+	else
+		out->fp = fopen(outfile,"wb");
+	if (NULL != out->fp)
+		setvbuf(out->fp,NULL,_IONBF,0);  // We do the buffering
+	if (NULL == out->fp)
+#else
+	struct stat st;  // For the size of a file we're adding to
+
+	if (out->IsStdout)
+	{
+		fflush(stdout);
+		out->fd = fileno(stdout);
+	}
+	else if (Keep)
+	{  // Cut it back to Keep and add on from there
+		if ((out->fd = open(outfile,O_WRONLY)) >= 0
+			&& (fstat(out->fd,&st) || (unsigned long long) st.st_size < Keep
+				|| ftruncate(out->fd,(off_t) Keep) || lseek(out->fd,(off_t) Keep,SEEK_SET) != (off_t) Keep))
+		{
+			close(out->fd);
+			out->fd = -1;
+		}
+	}
+	else
+	{
+		// Replace a file linked from the --cache, so that copy doesn't change
+		if (!stat(outfile,&st) && S_ISREG(st.st_mode) && st.st_nlink > 1)
+			unlink(outfile);
+		out->fd = open(outfile,O_WRONLY | O_CREAT | O_TRUNC,0666);
+	}
+	if (out->fd < 0)
+#endif
+	{
+		FreeOut(out);
+		return (NULL);
+	}
+
+	if (!StartZip(out))
+	{
+#ifdef _WIN32
+		fclose(out->fp);
+#else
+		close(out->fd);
+#endif
+		remove(outfile);
+		FreeOut(out);
+		return (NULL);
+	}
+
+	// Binary files start with a header
+	if (BinOut && !Keep)
+		PutOut(out,BIN_MAGIC,5);
+
+	if (out->Threaded)
+		out->Writer = std::thread(WriteThread,out);
+
+	return (out);
+}
+
+// OpenSink() Function
+//   Sets up output that goes to a function
+//   instead of a file, for DualExtruder.
+//
+// Inputs: Sink - Gets the output in blocks
+//         Ctx - Passed to Sink
+//
+// Outputs: File, NULL if out of memory
+//
+OutFile *OpenSink(DualSink Sink, void *Ctx)
+{
+	OutFile *out = NewOut(SINKBUFSIZE,0);  // Sink is only called from the caller's thread
+
+	if (NULL != out)
+	{
+		out->Sink = Sink;
+		out->SinkCtx = Ctx;
+		if (BinOut)
+			PutOut(out,BIN_MAGIC,5);
+	}
+
+	return (out);
+}
+
+// NewOut() Function
+//   Makes an output file with its buffer(s),
+//   before it's opened. The write thread's
+//   ring takes RINGSLOTS buffers of Size.
+//
+// Inputs: Size - Buffer size
+//         Threaded - Will use the write thread
+//
+// Outputs: File, NULL if out of memory
+//
+OutFile *NewOut(size_t Size, int Threaded)
+{
+	OutFile *out = new OutFile;
+
+	out->IsStdout = 0;
+	out->Sink = NULL;
+	out->SinkCtx = NULL;
+	out->Len = 0;
+	out->Size = Size;
+	out->Failed = 0;
+	out->Written = out->Kept = out->Queued = 0;
+	out->CkptName = NULL;
+	out->IdxName = NULL;
+	memset(&out->Layers,0,sizeof(out->Layers));
+	out->CkptIn = 0;
+	out->ZipBuf = NULL;
+	out->Big = NULL;
+	out->BigSize = 0;
+	out->Zip = ZIP_NONE;
+	out->Threaded = Threaded;
+
+	// The write thread's buffers come from its ring
+	if (out->Threaded)
+		out->Buf = RingAlloc(&out->Ring,out->Size) ? RingSpace(&out->Ring) : NULL;
+	else
+		out->Buf = (char *) malloc(out->Size);
+	if (NULL == out->Buf)
+	{
+		FreeOut(out);
+		return (NULL);
+	}
+
+	return (out);
+}
+
+// FreeOut() Function
+//   Frees an output file's buffers,
+//   after it's closed.
+//
+// Inputs: out - Output file
+//
+void FreeOut(OutFile *out)
+{
+	if (out->Threaded)
+		RingRelease(&out->Ring);
+	else
+		free(out->Buf);
+	free(out->Big);
+	free(out->CkptName);
+	free(out->IdxName);
+	free(out->Layers.Marks);
+	delete out;
+}
+
+// OutZip() Function
+//   Picks the compression for an output
+//   file from its name.
+//
+// Inputs: outfile - Output file name
+//
+// Outputs: ZIP_GZ for .gz, ZIP_ZSTD for .zst, ZIP_NONE otherwise
+//
+int OutZip(const char *outfile)
+{
+	size_t NameLen = strlen(outfile);
+
+	if (NameLen > 3 && !strcmp(outfile + NameLen - 3,".gz"))
+		return (ZIP_GZ);
+	if (NameLen > 4 && !strcmp(outfile + NameLen - 4,".zst"))
+		return (ZIP_ZSTD);
+
+	return (ZIP_NONE);
+}
+
+// CloseOut() Function
+//   Writes what's left and closes
+//   a file opened with OpenOut().
+//
+// Inputs: out - File to close
+//
+// Outputs: Sucess/Failure if anything couldn't be written
+//
+int CloseOut(OutFile *out)
+{
+	int Ok;
+	double Wait;  // For --stats
+
+	FlushOut(out);
+	Wait = ShowStats ? GetTime() : 0;
+
+	if (out->Threaded)
+	{
+		// Let the write thread finish
+		RingEnd(&out->Ring);
+		out->Writer.join();
+	}
+
+	// Finish the compressed data
+	if (ZIP_NONE != out->Zip)
+	{
+		ZipBlock(out,NULL,0,1);
+#ifdef USE_ZLIB
+		if (ZIP_GZ == out->Zip)
+			deflateEnd(&out->Gz);
+#endif
+#ifdef USE_ZSTD
+		if (ZIP_ZSTD == out->Zip)
+			ZSTD_freeCCtx(out->Zs);
+#endif
+		free(out->ZipBuf);
+	}
+
+#ifdef _WIN32
+	if (!out->IsStdout && NULL == out->Sink && fclose(out->fp))
+		out->Failed = 1;
+#else
+	if (!out->IsStdout && NULL == out->Sink && close(out->fd))
+		out->Failed = 1;
+#endif
+
+	if (ShowStats)
+		Stats.IoWait += GetTime() - Wait;
+	Stats.BytesOut += out->Written - out->Kept;
+
+	Ok = !out->Failed;
+	FreeOut(out);
+
+	return (Ok);
+}
+
+// OutSpace() Function
+//   Makes room in the output buffer.
+//
+// Inputs: out - Output file
+//         Need - Bytes needed, less than the buffer size
+//
+// Outputs: Where they go, the caller adds what it used to out->Len
+//
+char *OutSpace(OutFile *out, size_t Need)
+{
+	if (out->Size - out->Len < Need)
+		FlushOut(out);
+
+	return (out->Buf + out->Len);
+}
+
+// PutOut() Function
+//   Adds a block of data to the output.
+//
+// Inputs: out - Output file
+//         Data - Data to add
+//         Len - Bytes to add
+//
+void PutOut(OutFile *out, const char *Data, size_t Len)
+{
+	size_t Part;
+
+	while (Len)
+	{
+		if (out->Len == out->Size)
+			FlushOut(out);
+
+		Part = out->Size - out->Len;
+		if (Part > Len)
+			Part = Len;
+		memcpy(out->Buf + out->Len,Data,Part);
+		out->Len += Part;
+		Data += Part;
+		Len -= Part;
+	}
+}
+
+// CopySpan() Function
+//   Adds lines from the input file to the
+//   output as they are. Long runs from a mapped
+//   file to a plain output file are copied by
+//   the kernel, without going thru the buffer.
+//
+// Inputs: out - Output file
+//         in - Input file
+//         Span - Lines to copy, in in->Data
+//         Len - Bytes to copy
+//
+void CopySpan(OutFile *out, InFile *in, const char *Span, size_t Len)
+{
+#ifdef _WIN32
+	(void) in;
+	PutOut(out,Span,Len);
+#else
+	double Wait;  // For --stats
+	size_t Done = 0;  // Bytes copied
+#ifdef __linux__
+	off_t Pos = (off_t) (Span - in->Data);  // Where they are in the file
+	ssize_t Got;
+	int Send = 0;  // copy_file_range() didn't work, try sendfile()
+#endif
+
+	if (Len < SPANCOPY || !in->Mapped || NULL != out->Sink || ZIP_NONE != out->Zip)
+	{
+		PutOut(out,Span,Len);
+		return;
+	}
+
+	// What's in the buffers goes first
+	WaitOut(out);
+	if (out->Failed)
+		return;
+	out->Queued += Len;
+	Wait = ShowStats ? GetTime() : 0;
+
+#ifdef __linux__
+	// copy_file_range() only works between normal files,
+	// sendfile() works for pipes too
+	while (Done < Len)
+	{
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (2 == __GLIBC__ && __GLIBC_MINOR__ >= 27))
+		if (!Send)
+			Got = copy_file_range(in->fd,&Pos,out->fd,NULL,Len - Done,0);
+		else
+#endif
+			Got = sendfile(out->fd,in->fd,&Pos,Len - Done);
+		if (Got < 0 && EINTR == errno)
+			continue;
+		if (Got <= 0)
+		{
+			if (Send)
+				break;
+			Send = 1;
+			continue;
+		}
+		Done += (size_t) Got;
+		out->Written += (size_t) Got;
+	}
+#endif
+
+	// Anything the kernel wouldn't copy is written from the mapping
+	WriteRaw(out,Span + Done,Len - Done);
+	if (ShowStats)
+		Stats.IoWait += GetTime() - Wait;
+#endif
+}
+
+// WaitOut() Function
+//   Writes everything in the output buffers,
+//   waiting for the write thread to finish.
+//
+// Inputs: out - Output file
+//
+void WaitOut(OutFile *out)
+{
+	FlushOut(out);
+
+	if (out->Threaded)
+		RingWait(&out->Ring,RING_IDLE);
+}
+
+// FlushOut() Function
+//   Writes the output buffer, or hands it
+//   to the write thread and switches to
+//   the next free one.
+//
+// Inputs: out - Output file
+//
+void FlushOut(OutFile *out)
+{
+	double Wait;  // For --stats
+
+	if (!out->Len)
+		return;
+
+	PROF_START(PROF_WRITE);
+	out->Queued += out->Len;
+	Wait = ShowStats ? GetTime() : 0;
+	if (!out->Threaded)
+	{
+		WriteBlock(out,out->Buf,out->Len);
+		out->Len = 0;
+		if (ShowStats)
+			Stats.IoWait += GetTime() - Wait;
+		PROF_END(PROF_WRITE);
+		return;
+	}
+
+	// Hand it to the write thread and fill the next one,
+	// waiting if they're all still being written
+	RingPut(&out->Ring,out->Len);
+	out->Buf = RingSpace(&out->Ring);
+	out->Len = 0;
+	if (ShowStats)
+		Stats.IoWait += GetTime() - Wait;
+	PROF_END(PROF_WRITE);
+}
+
+// SyncOut() Function
+//   Writes everything in the output buffers
+//   and waits for it to reach the disk.
+//
+// Inputs: out - Output file
+//
+// Outputs: Sucess/Failure
+//
+int SyncOut(OutFile *out)
+{
+	WaitOut(out);
+
+#ifdef _WIN32
+	if (!out->Failed && _commit(_fileno(out->fp)))
+		out->Failed = 1;
+#else
+	if (!out->Failed && fsync(out->fd))
+		out->Failed = 1;
+#endif
+
+	return (!out->Failed);
+}
+
+// WriteThread() Function
+//   Writes buffers handed over by FlushOut()
+//   until CloseOut() stops it.
+//
+// Inputs: out - Output file
+//
+void WriteThread(OutFile *out)
+{
+	const char *Data;  // Next buffer
+	size_t Len;  // Bytes in it
+
+	// Until CloseOut() is done and they're all written
+	while (NULL != (Data = RingGet(&out->Ring,&Len)))
+	{
+		WriteBlock(out,Data,Len);
+		RingDone(&out->Ring);
+	}
+}
+
+// WriteBlock() Function
+//   Writes a block to the output file.
+//
+// Inputs: out - Output file, Failed set on errors
+//         Data - Data to write
+//         Len - Bytes to write
+//
+void WriteBlock(OutFile *out, const char *Data, size_t Len)
+{
+	if (ZIP_NONE != out->Zip)
+		ZipBlock(out,Data,Len,0);
+	else
+		WriteRaw(out,Data,Len);
+}
+
+// StartZip() Function
+//   Sets up the compressor for a .gz/.zst
+//   output file.
+//
+// Inputs: out - Output file, out->Zip is the compression to use
+//
+// Outputs: Sucess/Failure
+//
+int StartZip(OutFile *out)
+{
+	int Ok = 1;
+
+	switch (out->Zip)
+	{
+	case ZIP_NONE:
+		return (1);
+	case ZIP_GZ:
+#ifdef USE_ZLIB
+		memset(&out->Gz,0,sizeof(out->Gz));
+		Ok = (Z_OK == deflateInit2(&out->Gz,Z_DEFAULT_COMPRESSION,Z_DEFLATED,15 + 16,8,Z_DEFAULT_STRATEGY));
+#else
+		fprintf(Msg,"ERROR: This build can't write gzip files\n");
+		return (0);
+#endif
+		break;
+	case ZIP_ZSTD:
+#ifdef USE_ZSTD
+		Ok = (NULL != (out->Zs = ZSTD_createCCtx()));
+#else
+		fprintf(Msg,"ERROR: This build can't write zstd files\n");
+		return (0);
+#endif
+		break;
+	}
+
+	if (Ok && NULL == (out->ZipBuf = (char *) malloc(ZIPBLOCK)))
+	{
+		Ok = 0;
+#ifdef USE_ZLIB
+		if (ZIP_GZ == out->Zip)
+			deflateEnd(&out->Gz);
+#endif
+#ifdef USE_ZSTD
+		if (ZIP_ZSTD == out->Zip)
+			ZSTD_freeCCtx(out->Zs);
+#endif
+	}
+
+	return (Ok);
+}
+
+// ZipBlock() Function
+//   Compresses a block and writes
+//   the compressed data.
+//
+// Inputs: out - Output file, Failed set on errors
+//         Data - Data to compress
+//         Len - Bytes to compress
+//         Finish - End the compressed data after this block
+//
+void ZipBlock(OutFile *out, const char *Data, size_t Len, int Finish)
+{
+	size_t Done;  // Compressed bytes in ZipBuf
+	int End = 0;  // Compressor is finished
+
+#if !defined(USE_ZLIB) && !defined(USE_ZSTD)
+	(void) Data;  // Built without either, StartZip() fails first
+	(void) Len;
+	(void) Finish;
+#endif
+
+	while (!out->Failed && !End)
+	{
+		Done = 0;
+		End = 1;
+
+#ifdef USE_ZLIB
+		if (ZIP_GZ == out->Zip)
+		{
+			int Ret;
+
+			out->Gz.next_in = (Bytef *) Data;
+			out->Gz.avail_in = (uInt) Len;
+			out->Gz.next_out = (Bytef *) out->ZipBuf;
+			out->Gz.avail_out = ZIPBLOCK;
+
+			Ret = deflate(&out->Gz,Finish ? Z_FINISH : Z_NO_FLUSH);
+			if (Z_STREAM_ERROR == Ret)
+				out->Failed = 1;
+			Data += Len - out->Gz.avail_in;
+			Len = out->Gz.avail_in;
+			Done = ZIPBLOCK - out->Gz.avail_out;
+			End = Finish ? (Z_STREAM_END == Ret) : (!Len && out->Gz.avail_out);
+		}
+#endif
+
+#ifdef USE_ZSTD
+		if (ZIP_ZSTD == out->Zip)
+		{
+			ZSTD_inBuffer In = { Data, Len, 0 };
+			ZSTD_outBuffer Zo = { out->ZipBuf, ZIPBLOCK, 0 };
+			size_t Ret;
+
+			Ret = ZSTD_compressStream2(out->Zs,&Zo,&In,Finish ? ZSTD_e_end : ZSTD_e_continue);
+			if (ZSTD_isError(Ret))
+				out->Failed = 1;
+			Data += In.pos;
+			Len -= In.pos;
+			Done = Zo.pos;
+			End = Finish ? (0 == Ret) : (!Len);
+		}
+#endif
+
+		if (!out->Failed)
+			WriteRaw(out,out->ZipBuf,Done);
+	}
+}
+
+// WriteRaw() Function
+//   Writes a block to the output file,
+//   after any compression.
+//
+// Inputs: out - Output file, Failed set on errors
+//         Data - Data to write
+//         Len - Bytes to write
+//
+void WriteRaw(OutFile *out, const char *Data, size_t Len)
+{
+	if (out->Failed)  // Don't bother after an error
+		return;
+
+	if (NULL != out->Sink)
+	{
+		if (!out->Sink(out->SinkCtx,Data,Len))
+			out->Failed = 1;
+		out->Written += Len;
+		return;
+	}
+
+#ifdef _WIN32
+	if (fwrite(Data,1,Len,out->fp) != Len)
+		out->Failed = 1;
+	out->Written += Len;
+#else
+	ssize_t Done;
+
+	while (Len)
+	{
+		if ((Done = write(out->fd,Data,Len)) < 0)
+		{
+			if (EINTR == errno)
+				continue;
+			out->Failed = 1;
+			return;
+		}
+		Data += Done;
+		Len -= (size_t) Done;
+		out->Written += (size_t) Done;
+	}
+#endif
+}
+
+// AddStats() Function
+//   Adds the counters from another thread.
+//
+// Inputs: To - Counters to add to
+//         From - Counters to add
+//
+void AddStats(ConvStats *To, const ConvStats *From)
+{
+	int n;
+
+	To->IoWait += From->IoWait;
+	for (n = 0; n < NUMCODES; ++n)
+		To->Codes[n] += From->Codes[n];
+	To->Rewrites += From->Rewrites;
+}
+
+// PrintStats() Function
+//   Shows the --stats counters for a file
+//   on one line of JSON.
+//
+// Inputs: infile - File converted
+//         outfile - Converted file
+//         Ok - Conversion worked
+//
+void PrintStats(const char *infile, const char *outfile, int Ok)
+{
+	long PeakRSS = -1;  // Peak memory use in KB, -1 if not known
+	int n;
+
+#ifndef _WIN32
+	struct rusage Usage;
+
+	if (!getrusage(RUSAGE_SELF,&Usage))
+	{
+#ifdef __APPLE__
+		PeakRSS = Usage.ru_maxrss / 1024;  // In bytes there
+#else
+		PeakRSS = Usage.ru_maxrss;
+#endif
+	}
+#endif
+
+	fprintf(Msg,"{\"infile\":");
+	PutJson(infile);
+	fprintf(Msg,",\"outfile\":");
+	if (NULL != outfile)
+		PutJson(outfile);
+	else
+		fprintf(Msg,"null");
+	fprintf(Msg,",\"ok\":%s,\"cached\":%s,\"lines\":%d",Ok ? "true" : "false",Stats.Cached ? "true" : "false",Stats.Lines);
+	fprintf(Msg,",\"time\":{\"check\":%.6f,\"convert\":%.6f,\"verify\":%.6f,\"io_wait\":%.6f,\"total\":%.6f}",
+		Stats.CheckTime,Stats.ConvTime,Stats.VerifyTime,Stats.IoWait,GetTime() - Stats.Start);
+	fprintf(Msg,",\"bytes_in\":%llu,\"bytes_out\":%llu,\"codes\":{",Stats.BytesIn,Stats.BytesOut);
+	for (n = 0; n < NUMCODES; ++n)
+		fprintf(Msg,"%s\"%s\":%lu",n ? "," : "",CODES[n],Stats.Codes[n]);
+	fprintf(Msg,"},\"e_rewrites\":%lu",Stats.Rewrites);
+	if (Stats.Analyzed)
+	{
+		fprintf(Msg,",\"analysis\":{\"moves\":%d,\"travel_mm\":%.3f,\"time_s\":%.3f,\"filament_mm\":[",
+			Stats.Moves,Stats.Travel,Stats.PrintTime);
+		for (n = 0; n < NumHeads; ++n)
+			fprintf(Msg,"%s%.3f",n ? "," : "",Stats.Filament[n]);
+		fprintf(Msg,"]}");
+	}
+	if (Stats.Streamed)
+		fprintf(Msg,",\"latency_us\":{\"p50\":%.3f,\"p90\":%.3f,\"p99\":%.3f,\"max\":%.3f}",
+			Stats.LatP50 * 1e6,Stats.LatP90 * 1e6,Stats.LatP99 * 1e6,Stats.LatMax * 1e6);
+	if (PeakRSS >= 0)
+		fprintf(Msg,",\"peak_rss_kb\":%ld}\n",PeakRSS);
+	else
+		fprintf(Msg,",\"peak_rss_kb\":null}\n");
+}
+
+// PutJson() Function
+//   Shows a string as a JSON string.
+//
+// Inputs: Str - String to show
+//
+void PutJson(const char *Str)
+{
+	fputc('"',Msg);
+	for (; *Str; ++Str)
+	{
+		if ('"' == *Str || '\\' == *Str)
+			fprintf(Msg,"\\%c",*Str);
+		else if ((unsigned char) *Str < 0x20)
+			fprintf(Msg,"\\u%04x",(unsigned char) *Str);
+		else
+			fputc(*Str,Msg);
+	}
+	fputc('"',Msg);
+}
+
+// DualExtruder class
+//   Converts a file fed to it in pieces, for
+//   programs that use DualExtrude.cpp as a
+//   library. The conversion state lives in
+//   the object, and is swapped into the
+//   thread's globals during each call.
+
+// Conversion code globals for one job
+struct ConvVars {
+	int LeftUsed, RightUsed;
+	double FirstE;
+	int RelativeE;
+	double Ratio[MAXHEADS - 1];
+	FILE *Msg;
+	ConvStats Stats;
+};
+
+// Everything a DualExtruder needs
+struct DualState {
+	ConvVars Vars;  // This job's globals
+	ConvVars Caller;  // The thread's globals, while in a call
+	OutFile *out;  // Buffers the converted lines for the sink
+	HeldLines Held;  // Lines before the toolhead is known
+	char *Carry;  // Partial line from the end of the last feed()
+	size_t CarryLen;  // Bytes in Carry
+	size_t CarrySize;  // Bytes allocated for Carry
+	int cnt;  // Line counter
+	int Found;  // Used toolhead is known
+	int Failed;  // Conversion error
+	int Done;  // finish() called
+};
+
+// EnterJob() Function
+//   Saves the thread's conversion globals
+//   and loads the job's.
+//
+// Inputs: State - Job
+//
+void EnterJob(DualState *State)
+{
+	ConvVars *V = &State->Caller;
+
+	V->LeftUsed = LeftUsed;
+	V->RightUsed = RightUsed;
+	V->FirstE = FirstE;
+	V->RelativeE = RelativeE;
+	memcpy(V->Ratio,Ratio,sizeof(Ratio));
+	V->Msg = Msg;
+	V->Stats = Stats;
+
+	V = &State->Vars;
+	LeftUsed = V->LeftUsed;
+	RightUsed = V->RightUsed;
+	FirstE = V->FirstE;
+	RelativeE = V->RelativeE;
+	memcpy(Ratio,V->Ratio,sizeof(Ratio));
+	Msg = V->Msg;
+	Stats = V->Stats;
+}
+
+// LeaveJob() Function
+//   Saves the job's conversion globals and
+//   puts back the thread's.
+//
+// Inputs: State - Job
+//
+void LeaveJob(DualState *State)
+{
+	ConvVars *V = &State->Vars;
+
+	V->LeftUsed = LeftUsed;
+	V->RightUsed = RightUsed;
+	V->FirstE = FirstE;
+	V->RelativeE = RelativeE;
+	memcpy(V->Ratio,Ratio,sizeof(Ratio));
+	V->Msg = Msg;
+	V->Stats = Stats;
+
+	V = &State->Caller;
+	LeftUsed = V->LeftUsed;
+	RightUsed = V->RightUsed;
+	FirstE = V->FirstE;
+	RelativeE = V->RelativeE;
+	memcpy(Ratio,V->Ratio,sizeof(Ratio));
+	Msg = V->Msg;
+	Stats = V->Stats;
+}
+
+// FeedLine() Function
+//   Converts one whole line for a job,
+//   the same as the ConvFileOnePass() loop.
+//
+// Inputs: State - Job
+//         Line - Line to convert
+//         Len - Length of the line
+//
+// Outputs: Sucess/Failure
+//
+int FeedLine(DualState *State, const char *Line, size_t Len)
+{
+	OutFile *out = State->out;
+
+	++State->cnt;  // Increment line counter
+
+	if (State->Found)
+		return (PutLine(out,Line,Len,State->cnt,1) && !out->Failed);
+
+	// Still looking for the used toolhead
+	if (!CheckLine(Line,Len))
+	{
+		fprintf(Msg,ERROR_BOTH);
+		return (0);
+	}
+	if (!RightUsed && !LeftUsed)
+		return (HoldLine(&State->Held,Line,Len,State->cnt));
+
+	// Found it, output the lines we held, then this one
+	State->Found = 1;
+
+	return (PutHeld(&State->Held,out) && PutLine(out,Line,Len,State->cnt,0) && !out->Failed);
+}
+
+// CarryLine() Function
+//   Adds to the partial line kept
+//   between feed() calls.
+//
+// Inputs: State - Job
+//         Data - Start of the line, or more of it
+//         Len - Bytes to add
+//
+// Outputs: Sucess/Failure
+//
+int CarryLine(DualState *State, const char *Data, size_t Len)
+{
+	char *NewCarry;
+
+	if (State->CarryLen + Len > State->CarrySize)
+	{
+		State->CarrySize = (State->CarryLen + Len) * 2;
+		if (NULL == (NewCarry = (char *) realloc(State->Carry,State->CarrySize)))
+		{
+			fprintf(Msg,"ERROR: Out of memory in line %d\n\n",State->cnt + 1);
+			return (0);
+		}
+		State->Carry = NewCarry;
+	}
+	memcpy(State->Carry + State->CarryLen,Data,Len);
+	State->CarryLen += Len;
+
+	return (1);
+}
+
+DualExtruder::DualExtruder(DualSink Sink, void *Ctx, FILE *Log)
+{
+	int n;
+
+	State = new DualState;
+	memset(&State->Vars,0,sizeof(State->Vars));
+	for (n = 0; n < MAXHEADS - 1; ++n)
+		State->Vars.Ratio[n] = 1.0;
+	State->Vars.Msg = Log;
+	State->Vars.Stats.Start = GetTime();
+	memset(&State->Held,0,sizeof(State->Held));
+	State->Carry = NULL;
+	State->CarryLen = 0;
+	State->CarrySize = 0;
+	State->cnt = 0;
+	State->Found = 0;
+	State->Done = 0;
+	State->Failed = (NULL == (State->out = OpenSink(Sink,Ctx)));
+	if (State->Failed)
+		fprintf(Log,"ERROR: Out of memory\n\n");
+}
+
+DualExtruder::~DualExtruder()
+{
+	if (NULL != State->out)
+	{  // Never finished, drop what's left
+		State->out->Len = 0;
+		CloseOut(State->out);
+	}
+	free(State->Held.Data);
+	free(State->Carry);
+	delete State;
+}
+
+int DualExtruder::diameters(const char *DiaIn, const char *DiaNew)
+{
+	int Ok;
+
+	EnterJob(State);
+	Ok = GetRatio(DiaIn,DiaNew);
+	LeaveJob(State);
+
+	return (Ok);
+}
+
+int DualExtruder::feed(const char *Data, size_t Len)
+{
+	const char *End;  // End of a line
+	size_t n;
+	int Lines;  // Lines copied as they are
+	int Ok = 1;
+
+	if (State->Failed || State->Done)
+		return (0);
+
+	EnterJob(State);
+
+	// Finish the line from the last call
+	if (State->CarryLen)
+	{
+		End = (const char *) memchr(Data,'\012',Len);
+		n = (NULL != End) ? (size_t) (End - Data) + 1 : Len;
+		Ok = CarryLine(State,Data,n);
+		Data += n;
+		Len -= n;
+		if (Ok && NULL != End)
+		{
+			Ok = FeedLine(State,State->Carry,State->CarryLen);
+			State->CarryLen = 0;
+		}
+	}
+
+	// Whole lines are converted where they are
+	while (Ok && Len)
+	{
+		// Copy lines that don't change, once the toolhead is known
+		if (State->Found && !BinOut && (n = ScanSpan(Data,Data + Len,0,&Lines)))
+		{
+			PutOut(State->out,Data,n);
+			State->cnt += Lines;
+			Data += n;
+			Len -= n;
+			continue;
+		}
+
+		if (NULL == (End = (const char *) memchr(Data,'\012',Len)))
+			break;
+		n = (size_t) (End - Data) + 1;
+		Ok = FeedLine(State,Data,n);
+		Data += n;
+		Len -= n;
+	}
+
+	// Keep the rest for next time
+	if (Ok && Len)
+		Ok = CarryLine(State,Data,Len);
+
+	LeaveJob(State);
+	State->Failed = !Ok;
+
+	return (Ok);
+}
+
+int DualExtruder::finish()
+{
+	int Ok = 1;
+
+	if (State->Failed || State->Done)
+		return (0);
+	State->Done = 1;
+
+	EnterJob(State);
+
+	// Last line, without a '\n'
+	if (State->CarryLen)
+	{
+		Ok = FeedLine(State,State->Carry,State->CarryLen);
+		State->CarryLen = 0;
+	}
+
+	if (Ok && !State->Found)
+	{
+		fprintf(Msg,"ERROR: Couldn't find a used extruder!\n\n");
+		Ok = 0;
+	}
+	Stats.Lines = State->cnt;
+
+	// Pass on the rest, or drop it if something went wrong
+	if (!Ok)
+		State->out->Len = 0;
+	if (!CloseOut(State->out))
+		Ok = 0;
+	State->out = NULL;
+
+	LeaveJob(State);
+	State->Failed = !Ok;
+
+	return (Ok);
+}
+
+int DualExtruder::lines() const
+{
+	return (State->cnt);
+}
+
+// RunBench() Function
+//   Times each stage of the conversion
+//   on a made up file.
+//
+//   Every stage starts from the file in
+//   memory, so each one includes splitting
+//   it into lines.
+//
+// Inputs: Spec - "default" or settings, "size=64,g1=85,...",
+//                settings can follow "default," too
+//
+// Outputs: Sucess/Failure, fails if converting is under min=
+//
+int RunBench(const char *Spec)
+{
+	static const char *Names[4] = { "g1", "m101", "m104", "m108" };
+	static const char *Stages[6] = { "read", "tokenize", "CheckCode", "scan CODES", "convert", "write" };
+	int Mix[4] = { 85, 3, 1, 1 };  // Percent of G1, M101/M103, M104, M108 lines
+	int EPct = 90;  // Percent of G1 lines with an 'E'
+	size_t Size = 64;  // File size in MB
+	int MinRate = 0;  // Slowest convert MB/s that passes, 0 for any
+	double Rate = 0;  // Convert MB/s
+	InHash Hash;  // Of the converted file
+	char Key[16];  // Setting name
+	int Val;  // Setting value
+	int Used;  // Chars used for the setting
+	char *Data;  // Made up file
+	size_t Len;  // Bytes in Data
+	int Lines;  // Lines in Data
+	InFile in;  // Data, read like a mapped file
+	const char *Line;  // Current line
+	size_t LineLen;  // Length of the line
+	GLine Parse;  // Line being parsed
+	GToken Token;  // Next token
+	char *Out;  // Converted file
+	size_t OutLen;  // Bytes in Out
+	size_t NewLen;  // Length of a converted line
+	FILE *tmp;  // Where the write stage writes to
+	double Best[6];  // Best time for each stage
+	double Start, Took;
+	long Sum;  // Results of the stages that don't output anything
+	int Stage, Run, n;
+
+	// Get settings, the defaults are already set
+	if (!strncmp(Spec,"default",7) && (!Spec[7] || ',' == Spec[7]))
+		Spec += Spec[7] ? 8 : 7;
+	while (*Spec)
+	{
+		if (2 != sscanf(Spec,"%15[a-z0-9]=%d%n",Key,&Val,&Used) || Val < 0)
+		{
+			fprintf(Msg,"ERROR: Bad benchmark setting: %s\n\n",Spec);
+			return (0);
+		}
+		for (n = 0; n < 4 && strcmp(Key,Names[n]); ++n)
+			;
+		if (n < 4)
+			Mix[n] = Val;
+		else if (!strcmp(Key,"size") && Val > 0)
+			Size = (size_t) Val;
+		else if (!strcmp(Key,"e") && Val <= 100)
+			EPct = Val;
+		else if (!strcmp(Key,"min"))
+			MinRate = Val;
+		else
+		{
+			fprintf(Msg,"ERROR: Bad benchmark setting: %s\n\n",Spec);
+			return (0);
+		}
+		Spec += Used;
+		if (',' == *Spec)
+			++Spec;
+	}
+	if (Mix[0] + Mix[1] + Mix[2] + Mix[3] > 100)
+	{
+		fprintf(Msg,"ERROR: Benchmark line mix adds up to more than 100%%\n\n");
+		return (0);
+	}
+
+	// Make up the file
+	if (NULL == (Data = GenGCode(Size * 1024 * 1024,Mix,EPct,&Len,&Lines)))
+	{
+		fprintf(Msg,"ERROR: Out of memory for benchmark\n\n");
+		return (0);
+	}
+	if (NULL == (Out = (char *) malloc(Len * 4 + MAXOUT)) || NULL == (tmp = tmpfile()))
+	{
+		fprintf(Msg,"ERROR: Out of memory for benchmark\n\n");
+		free(Data);
+		free(Out);
+		return (0);
+	}
+
+	fprintf(Msg,"Benchmark: %.1f MB, %d lines, G1 %d%%, M101/M103 %d%%, M104 %d%%, M108 %d%%, E on %d%% of G1\n\n",
+		Len / (1024.0 * 1024.0),Lines,Mix[0],Mix[1],Mix[2],Mix[3],EPct);
+
+	// Best of 3 runs for each stage
+	Sum = 0;
+	OutLen = 0;
+	for (Stage = 0; Stage < 6; ++Stage)
+	{
+		Best[Stage] = 0;
+		for (Run = 0; Run < 3; ++Run)
+		{
+			// Made up file uses the right extruder
+			LeftUsed = 0;
+			RightUsed = 1;
+			FirstE = 0;
+
+			memset(&in,0,sizeof(in));
+			in.Data = Data;
+			in.Size = Len;
+
+			Start = GetTime();
+			switch (Stage)
+			{
+			case 0:  // Split into lines
+				while (ReadLine(&in,&Line,&LineLen))
+					Sum += (long) LineLen;
+				break;
+			case 1:  // Split lines into words
+				while (ReadLine(&in,&Line,&LineLen))
+				{
+					StartLine(&Parse,Line,LineLen);
+					while (NextToken(&Parse,&Token))
+						Sum += Token.Letter;
+				}
+				break;
+			case 2:  // Look up the command
+				while (ReadLine(&in,&Line,&LineLen))
+				{
+					StartLine(&Parse,Line,LineLen);
+					if (NextToken(&Parse,&Token))
+						Sum += CheckCode(&Token);
+				}
+				break;
+			case 3:  // Look it up the way 2.2 did, comparing with each of CODES
+				while (ReadLine(&in,&Line,&LineLen))
+				{
+					StartLine(&Parse,Line,LineLen);
+					if (NextToken(&Parse,&Token))
+					{
+						for (n = 0; n < NUMCODES && !TokenIs(&Token,CODES[n]); ++n)
+							;
+						Sum += n;
+					}
+				}
+				break;
+			case 4:  // Convert
+				OutLen = 0;
+				while (ReadLine(&in,&Line,&LineLen))
+				{
+					ConvLine(Line,LineLen,Out + OutLen,Len * 4 + MAXOUT - OutLen,&NewLen,0,0);
+					if (!NewLen)
+					{
+						memcpy(Out + OutLen,Line,LineLen);
+						NewLen = LineLen;
+					}
+					OutLen += NewLen;
+				}
+				break;
+			case 5:  // Write the converted file
+				rewind(tmp);
+				fwrite(Out,1,OutLen,tmp);
+				fflush(tmp);
+				break;
+			}
+			Took = GetTime() - Start;
+
+			if (!Run || Took < Best[Stage])
+				Best[Stage] = Took;
+		}
+
+		if (Best[Stage] <= 0)
+			Best[Stage] = 1e-9;
+		fprintf(Msg,"  %-10s %10.1f MB/s %10.2f M lines/s\n",Stages[Stage],
+			Len / (1024.0 * 1024.0) / Best[Stage],Lines / 1e6 / Best[Stage]);
+		if (4 == Stage)
+			Rate = Len / (1024.0 * 1024.0) / Best[Stage];
+	}
+
+	// The same settings make the same file, so the hash
+	// only changes if the conversion does
+	HashStart(&Hash);
+	HashAdd(&Hash,Out,OutLen);
+	fprintf(Msg,"\n  Output %.1f MB, hash %016llx\n",OutLen / (1024.0 * 1024.0),HashEnd(&Hash));
+	BenchSink = Sum;
+
+	fclose(tmp);
+	free(Out);
+	free(Data);
+
+	if (Rate < MinRate)
+	{
+		fprintf(Msg,"\nERROR: Converting ran at %.1f MB/s, under min=%d\n\n",Rate,MinRate);
+		return (0);
+	}
+
+	return (1);
+}
+
+// GenGCode() Function
+//   Makes up a MakerWare style single
+//   extruder file for RunBench().
+//
+// Inputs: Size - About how many bytes to make
+//         Mix - Percent of G1, M101/M103, M104 and M108 lines,
+//               the rest are comments
+//         EPct - Percent of G1 lines with an 'E'
+//         Len - Set to the bytes made
+//         Lines - Set to the lines made
+//
+// Outputs: File, NULL if out of memory
+//
+char *GenGCode(size_t Size, const int *Mix, int EPct, size_t *Len, int *Lines)
+{
+	char *Data;  // File being made
+	char *p;  // Where the next line goes
+	unsigned int Seed = 12345;  // Same file every time
+	unsigned int Pick;  // Random number for the line
+	double E = 0;  // Current 'E'
+	int On = 0;  // Extruder on
+	int cnt = 0;  // Line counter
+
+	if (NULL == (Data = (char *) malloc(Size + 256)))
+		return (NULL);
+
+	p = Data;
+	p += sprintf(p,"(Made up by DualExtrude --bench)\012M104 S230 T0\012M108 R3.0 T0\012M6 T0\012");
+	cnt += 4;
+
+	while ((size_t) (p - Data) < Size)
+	{
+		Seed = Seed * 1103515245 + 12345;
+		Pick = (Seed >> 16) % 100;
+
+		if (Pick < (unsigned int) Mix[0])  // Move
+		{
+			Seed = Seed * 1103515245 + 12345;
+			p += sprintf(p,"G1 X%.3f Y%.3f Z%.2f F%d",(Seed >> 16) % 100000 / 1000.0 - 50,
+				(Seed & 0xffff) % 100000 / 1000.0 - 50,0.2 + (cnt / 5000) * 0.2,(Seed & 1) ? 1800 : 3000);
+			if ((Seed >> 8) % 100 < (unsigned int) EPct)
+			{
+				E += ((Seed >> 4) % 1000) / 2000.0;
+				p += sprintf(p," E%.5f",E);
+			}
+			*p++ = '\012';
+		}
+		else if ((Pick -= Mix[0]) < (unsigned int) Mix[1])  // Extruder on/off
+		{
+			p += sprintf(p,"%s T0\012",On ? "M103" : "M101");
+			On = !On;
+		}
+		else if ((Pick -= Mix[1]) < (unsigned int) Mix[2])  // Temp
+			p += sprintf(p,"M104 S%d T0\012",220 + (int) ((Seed >> 20) % 20));
+		else if ((Pick -= Mix[2]) < (unsigned int) Mix[3])  // Speed
+			p += sprintf(p,"M108 R%.1f T0\012",1 + ((Seed >> 20) % 40) / 10.0);
+		else  // Comment
+			p += sprintf(p,"(<layer> %.2f )\012",0.2 + (cnt / 5000) * 0.2);
+		++cnt;
+	}
+
+	*Len = (size_t) (p - Data);
+	*Lines = cnt;
+
+	return (Data);
+}
+
+#ifdef DUALEXTRUDE_PROFILE
+// ProfStart() Function
+//   Starts a stage for the profile, timing
+//   1 in PROFSAMPLE of them.
+//
+// Inputs: Stage - PROF_READ, PROF_CLASSIFY, ...
+//
+void ProfStart(int Stage)
+{
+	ProfThread *Prof = NULL != ProfSelf ? ProfSelf : ProfJoin();
+
+	Prof->At[Stage] = (Prof->Calls[Stage]++ & (PROFSAMPLE - 1)) ? 0 : ProfClock();
+}
+
+// ProfEnd() Function
+//   Ends a stage, counting its time
+//   if it was timed.
+//
+// Inputs: Stage - Stage ProfStart() started
+//
+void ProfEnd(int Stage)
+{
+	ProfThread *Prof = ProfSelf;
+	unsigned long long Took;
+
+	if (!Prof->At[Stage])
+		return;
+
+	Took = ProfClock() - Prof->At[Stage];
+	++Prof->Counts[Stage][Took ? HighBit(Took) : 0];
+	Prof->Total[Stage] += Took;
+	if (Took > Prof->Max[Stage])
+		Prof->Max[Stage] = Took;
+	Prof->At[Stage] = 0;
+}
+
+// ProfJoin() Function
+//   Sets up the profile times for this
+//   thread, and shows them all at exit.
+//
+// Outputs: This thread's times
+//
+ProfThread *ProfJoin(void)
+{
+	static ProfThread Spare;  // Shared if out of memory, the times are rough then
+	ProfThread *Prof = (ProfThread *) calloc(1,sizeof(ProfThread));
+	std::lock_guard<std::mutex> Hold(ProfLock);
+
+	if (NULL == Prof)
+		return (ProfSelf = &Spare);
+
+	if (NULL == ProfList)
+		atexit(ProfDump);
+	Prof->Id = NULL != ProfList ? ProfList->Id + 1 : 0;
+	Prof->Next = ProfList;
+	ProfList = Prof;
+
+	return (ProfSelf = Prof);
+}
+
+// ProfDump() Function
+//   Shows the time each thread spent in each
+//   stage, with percentiles from the histograms.
+//
+void ProfDump(void)
+{
+	static const double Parts[3] = { 0.5, 0.9, 0.99 };
+	std::lock_guard<std::mutex> Hold(ProfLock);
+	ProfThread *Prof;
+	unsigned long long Timed, Want, Seen;
+	int Stage, Bit, n;
+
+	for (Prof = ProfList; NULL != Prof; Prof = Prof->Next)
+	{
+		fprintf(stderr,"Profile for thread %d, 1 in %d calls timed, in %s:\n",Prof->Id,PROFSAMPLE,
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+			"cycles");
+#else
+			"ns");
+#endif
+		for (Stage = 0; Stage < PROFSTAGES; ++Stage)
+		{
+			for (Timed = 0, Bit = 0; Bit < 64; ++Bit)
+				Timed += Prof->Counts[Stage][Bit];
+			if (!Timed)
+				continue;
+
+			fprintf(stderr,"  %-10s %12llu calls %10llu timed  mean %9.1f",PROFNAMES[Stage],
+				Prof->Calls[Stage],Timed,(double) Prof->Total[Stage] / Timed);
+
+			// Each bucket holds times under the next power of 2
+			for (n = 0; n < 3; ++n)
+			{
+				Want = (unsigned long long) ceil(Parts[n] * Timed);
+				for (Seen = 0, Bit = 0; Bit < 63 && (Seen += Prof->Counts[Stage][Bit]) < Want; ++Bit)
+					;
+				fprintf(stderr,"  p%g <%llu",Parts[n] * 100,2ULL << Bit);
+			}
+			fprintf(stderr,"  max %llu\n",Prof->Max[Stage]);
+		}
+	}
+}
+
+// ProfClock() Function
+//   Gets a time stamp for the profile.
+//
+// Outputs: CPU cycles where there's a counter
+//          for them, otherwise ns
+//
+unsigned long long ProfClock(void)
+{
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+	return (__rdtsc());
+#else
+	return ((unsigned long long) std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+#endif
+
+// GetTime() Function
+//   Gets a time in seconds for RunBench() and --stats.
+//
+// Outputs: Seconds from some fixed point
+//
+double GetTime(void)
+{
+	return (std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
@@ -0,0 +1,48 @@
+// DualExtrude.h : Convert gcode from inside another program
+// Copyright (c) 2012, Joe Cabana    Joey@JSConsulting.com
+//
+// Build DualExtrude.cpp with -DDUALEXTRUDE_NO_MAIN to link it into
+// a program, see DualExtrude.cpp for the license.
+
+#ifndef DUALEXTRUDE_H
+#define DUALEXTRUDE_H
+
+#include <stdio.h>
+#include <stddef.h>
+
+// Where converted gcode goes, returns 0 to stop the conversion
+typedef int (*DualSink)(void *Ctx, const char *Data, size_t Len);
+
+// Converts one single extruder file fed to it in pieces of any size,
+// the same way "DualExtrude --single-pass" does. Each one has its own
+// state, so any number can be used at once, from one thread or many,
+// but each one from only one thread at a time.
+class DualExtruder {
+public:
+	// Sink gets the converted file in blocks, Log gets error messages
+	DualExtruder(DualSink Sink, void *Ctx, FILE *Log = stderr);
+	~DualExtruder();
+
+	// Sets the filament diameters, before the first feed()
+	// Outputs: Sucess/Failure
+	int diameters(const char *DiaIn, const char *DiaNew);
+
+	// Converts the next piece of the file, lines can be split anywhere
+	// Outputs: Sucess/Failure, nothing else is converted after a failure
+	int feed(const char *Data, size_t Len);
+
+	// Converts the last line and passes everything left to the sink
+	// Outputs: Sucess/Failure
+	int finish();
+
+	// Lines converted so far
+	int lines() const;
+
+private:
+	struct DualState *State;
+
+	DualExtruder(const DualExtruder &);  // Not copyable
+	DualExtruder &operator=(const DualExtruder &);
+};
+
+#endif
@@ -0,0 +1,74 @@
+#!/usr/bin/env python3
+# Checks a --binary output file against the text output it stands for
+#
+# Usage: bincheck.py out.bin golden.gcode
+#
+# Strings have to be the same bytes. Moves have to have the same
+# words with the same values, the binary format keeps them as
+# fixed point so 1.0 and 1 are the same there.
+
+import sys
+
+# Move fields in mask bit order, with their size and scale
+FIELDS = [('X', 4, 1e3), ('Y', 4, 1e3), ('Z', 4, 1e3), ('F', 4, 1e3), ('A', 8, 1e5), ('B', 8, 1e5)]
+
+def main():
+	data = open(sys.argv[1], 'rb').read()
+	text = open(sys.argv[2], 'rb').read().split(b'\n')
+	if text and text[-1] == b'':
+		text.pop()
+	if data[:5] != b'DEGB\x01':
+		sys.exit('%s: not a version 1 binary file' % sys.argv[1])
+
+	pos = [5]
+	def varint():
+		val = shift = 0
+		while True:
+			b = data[pos[0]]
+			pos[0] += 1
+			val |= (b & 0x7f) << shift
+			shift += 7
+			if b < 0x80:
+				return val
+	def take(n):
+		s = data[pos[0]:pos[0] + n]
+		pos[0] += n
+		return s
+
+	table = []
+	lines = []
+	while pos[0] < len(data):
+		rec = data[pos[0]]
+		pos[0] += 1
+		if 1 == rec:  # Move
+			mask = data[pos[0]]
+			pos[0] += 1
+			words = {}
+			for bit, (letter, size, scale) in enumerate(FIELDS):
+				if mask >> bit & 1:
+					words[letter] = int.from_bytes(take(size), 'little', signed=True) / scale
+			lines.append(words)
+		elif 2 == rec:  # New string, added to the table
+			table.append(take(varint()))
+			lines.append(table[-1])
+		elif 3 == rec:  # String from the table
+			lines.append(table[varint()])
+		elif 4 == rec:  # String not kept
+			lines.append(take(varint()))
+		else:
+			sys.exit('%s: bad record %d at %d' % (sys.argv[1], rec, pos[0] - 1))
+
+	if len(lines) != len(text):
+		sys.exit('%d lines, %s has %d' % (len(lines), sys.argv[2], len(text)))
+	for num, (got, line) in enumerate(zip(lines, text), 1):
+		if isinstance(got, bytes):
+			ok = got == line
+		else:
+			tokens = line.split()
+			want = dict((t[:1].decode(), float(t[1:])) for t in tokens[1:])
+			ok = tokens[:1] == [b'G1'] and set(want) == set(got) and \
+				all(abs(want[k] - got[k]) < 1e-9 * max(1, abs(want[k])) for k in want)
+		if not ok:
+			sys.exit('Line %d differs: %r' % (num, line))
+
+main()
@@ -0,0 +1,156 @@
+(**** This is a build header ****)
+(**** Generated by MakerWare style test input ****)
+M103 T0 (disable extruder)
+M73 P0 (enable build progress)
+G21 (set units to mm)
+G90 (set positioning to absolute)
+M109 S110 T0 (set HBP temperature)
+M104 S230 T0 (set extruder temperature)
+(**** end of start.gcode ****)
+M108 R3.0 T0 (set extruder speed)
+M6 T0 (wait for toolhead parts, nozzle, HBP, etc., to reach temperature)
+G1 X-10.0 Y-10.0 Z0.2 F3300.0 (move to waiting position)
+(<layer> 0.200 )
+G1 X-15.722 Y2.654 Z0.200 F3000.0
+M101 T0 (extruder on, forward)
+G1 X-1.557 Y4.851 Z0.200 F3143.5 E1.37812
+G1 X3.047 Y-18.495 Z0.200 F3612.0 E2.10851
+G1 X-6.172 Y21.661 Z0.200 F1574.1 E2.95547
+G1 X-6.604 Y-29.091 Z0.200 F3864.4 E4.34793
+G1 X-27.433 Y16.805 Z0.200 F4059.0 E5.78630
+G1 X25.209 Y-6.743 Z0.200 F3910.1 E6.69869
+G1 X4.615 Y27.846 Z0.200 F1163.4 E7.80447
+G1 X-0.307 Y-14.521 Z0.200 F3422.6 E7.90651
+G1 X-4.731 Y20.009 Z0.200 F3010.9 E9.19659
+G1 X-16.057 Y-9.794 Z0.200 F4446.1 E9.83757
+M108 R1.8 T0
+M103 T0 (extruder off)
+(<layer> 0.400 )
+G1 X6.349 Y11.734 Z0.400 F3000.0
+M101 T0 (extruder on, forward)
+G1 X27.878 Y24.282 Z0.400 F2990.3 E11.13550
+G1 X19.896 Y4.412 Z0.400 F1796.8 E11.49163
+M108 R3.6 T0
+G1 X-24.689 Y18.036 Z0.400 F2323.9 E12.97685
+G1 X16.128 Y22.366 Z0.400 F785.6 E13.45299
+G1 X13.106 Y-10.143 Z0.400 F4299.8 E13.56815
+G1 X29.911 Y-11.420 Z0.400 F923.3 E14.35101
+G1 X-18.157 Y-5.524 Z0.400 F3164.0 E14.44651
+G1 X22.067 Y-11.170 Z0.400 F4626.4 E14.55804
+G1 X-2.375 Y1.204 Z0.400 F3304.3 E15.15584
+G1 X7.208 Y26.437 Z0.400 F2729.5 E16.01676
+G1 X-15.742 Y-11.935 Z0.400 F4706.7 E17.11121
+G1 X-29.313 Y-5.087 Z0.400 F3035.9 E17.95644
+M108 R2.8 T0
+G1 X-26.395 Y7.640 Z0.400 F2558.3 E18.92310
+M103 T0 (extruder off)
+(<layer> 0.600 )
+G1 X-8.845 Y12.417 Z0.600 F3000.0
+M101 T0 (extruder on, forward)
+G1 X5.363 Y27.290 Z0.600 F689.3 E19.68288
+G1 X-12.082 Y6.087 Z0.600 F1345.2 E20.64344
+G1 X20.630 Y-14.152 Z0.600 F3906.7 E21.79269
+M108 R3.4 T0
+G1 X11.024 Y-22.115 Z0.600 F2700.0 E23.25118
+G1 X-10.333 Y10.684 Z0.600 F3328.1 E23.69178
+M108 R2.8 T0
+G1 X10.496 Y-16.532 Z0.600 F4001.0 E25.11805
+G1 X14.524 Y-16.919 Z0.600 F2987.3 E25.28397
+G1 X-27.965 Y27.455 Z0.600 F1923.6 E26.47513
+G1 X21.824 Y-9.593 Z0.600 F4077.4 E27.35864
+M108 R2.9 T0
+G1 X-4.724 Y1.104 Z0.600 F4169.9 E28.26339
+G1 X-12.576 Y4.100 Z0.600 F749.3 E29.23295
+G1 X-1.359 Y19.952 Z0.600 F3215.2 E29.57233
+G1 X29.146 Y13.036 Z0.600 F735.7 E30.43269
+M103 T0 (extruder off)
+(<layer> 0.800 )
+G1 X15.203 Y14.881 Z0.800 F3000.0
+M101 T0 (extruder on, forward)
+G1 X23.382 Y21.692 Z0.800 F4203.5 E31.27129
+G1 X-15.328 Y-27.891 Z0.800 F3972.4 E31.49529
+G1 X23.014 Y-4.207 Z0.800 F807.3 E31.83307
+G1 X0.191 Y-15.657 Z0.800 F683.3 E32.05825
+G1 X24.785 Y-23.185 Z0.800 F1126.7 E32.18545
+G1 X18.693 Y-26.318 Z0.800 F1527.4 E33.01988
+M108 R3.7 T0
+G1 X-15.633 Y-13.574 Z0.800 F4336.5 E33.24273
+M108 R3.8 T0
+G1 X4.254 Y-5.983 Z0.800 F3777.3 E33.99961
+G1 X1.180 Y-26.942 Z0.800 F1957.1 E34.94584
+G1 X16.515 Y-27.229 Z0.800 F809.3 E36.23852
+M103 T0 (extruder off)
+(<layer> 1.000 )
+G1 X-28.019 Y12.763 Z1.000 F3000.0
+M101 T0 (extruder on, forward)
+G1 X-11.046 Y-11.125 Z1.000 F2075.4 E0.77807
+G1 X-8.350 Y-18.535 Z1.000 F1980.9 E1.67866
+M108 R2.7 T0
+G1 X-7.186 Y-25.206 Z1.000 F1349.9 E2.76693
+G1 X16.957 Y-7.184 Z1.000 F3964.9 E3.69336
+G1 X-7.655 Y-0.231 Z1.000 F3552.1 E4.36917
+G1 X-2.350 Y-15.295 Z1.000 F2850.5 E5.42565
+G1 X-4.507 Y-4.449 Z1.000 F4294.6 E5.57944
+G1 X23.871 Y17.455 Z1.000 F1701.2 E6.17208
+G1 X18.793 Y9.737 Z1.000 F4326.8 E6.40064
+G1 X14.024 Y3.831 Z1.000 F1033.2 E7.41861
+G1 X-21.389 Y16.458 Z1.000 F786.1 E7.47571
+M108 R1.3 T0
+G1 X-19.251 Y-28.591 Z1.000 F4134.4 E8.80239
+M108 R3.5 T0
+M103 T0 (extruder off)
+M104 S225 T0
+(<layer> 1.200 )
+G1 X10.412 Y20.171 Z1.200 F3000.0
+M101 T0 (extruder on, forward)
+G1 X17.925 Y-27.824 Z1.200 F3823.2 E9.69205
+G1 X-23.595 Y14.938 Z1.200 F4525.2 E10.77903
+M108 R2.0 T0
+G1 X19.684 Y-15.472 Z1.200 F1355.0 E11.64680
+G1 X15.213 Y-6.376 Z1.200 F2143.4 E12.58997
+G1 X-4.907 Y-25.004 Z1.200 F2701.3 E13.14788
+G1 X14.845 Y-20.363 Z1.200 F3501.5 E13.79649
+G1 X1.026 Y-0.977 Z1.200 F3300.4 E14.82358
+G1 X-24.248 Y14.889 Z1.200 F4449.8 E15.09010
+G1 X13.135 Y-18.833 Z1.200 F1722.9 E15.78253
+G1 X-11.109 Y-16.062 Z1.200 F3502.8 E16.68168
+M103 T0 (extruder off)
+(<layer> 1.400 )
+G1 X-12.248 Y12.320 Z1.400 F3000.0
+M101 T0 (extruder on, forward)
+G1 X5.074 Y29.025 Z1.400 F4335.5 E17.59475
+G1 X18.246 Y-17.963 Z1.400 F2993.5 E18.03349
+G1 X21.828 Y-4.895 Z1.400 F3529.7 E18.78325
+G1 X4.831 Y24.105 Z1.400 F3340.1 E19.13160
+M108 R4.0 T0
+G1 X26.853 Y16.987 Z1.400 F4303.8 E19.28654
+M108 R3.7 T0
+G1 X8.895 Y16.640 Z1.400 F890.9 E20.62848
+G1 X23.410 Y16.548 Z1.400 F1177.4 E21.04703
+G1 X-27.794 Y26.027 Z1.400 F1312.8 E22.07598
+M108 R1.5 T0
+G1 X17.934 Y-22.922 Z1.400 F1709.5 E22.25787
+G1 X-2.859 Y14.046 Z1.400 F2013.9 E22.36026
+M108 R2.0 T0
+G1 X-25.322 Y8.658 Z1.400 F3718.0 E22.96078
+M103 T0 (extruder off)
+(<layer> 1.600 )
+G1 X-22.474 Y-10.871 Z1.600 F3000.0
+M101 T0 (extruder on, forward)
+G1 X-4.046 Y-3.695 Z1.600 F2815.4 E23.12134
+G1 X12.042 Y10.706 Z1.600 F2147.4 E23.93649
+G1 X10.198 Y26.653 Z1.600 F4032.9 E24.94769
+M108 R3.8 T0
+G1 X3.963 Y1.541 Z1.600 F3400.9 E25.48856
+G1 X-12.335 Y13.674 Z1.600 F3717.5 E25.62487
+G1 X-21.027 Y-7.753 Z1.600 F4463.9 E26.73366
+G1 X3.587 Y25.249 Z1.600 F3308.9 E26.94057
+G1 X-11.966 Y-18.786 Z1.600 F2626.0 E27.59977
+G1 X-23.555 Y-19.126 Z1.600 F2925.7 E28.67270
+G1 X-24.009 Y-13.749 Z1.600 F824.6 E29.29089
+M108 R2.4 T0
+M103 T0 (extruder off)
+M73 P100 (end build progress )
+M104 S0 T0 (turn off extruder)
+M109 S0 T0 (turn off HBP)
+(**** end of end.gcode ****)
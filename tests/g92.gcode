@@ -0,0 +1,145 @@
+(**** This is a build header ****)
+(**** Generated by MakerWare style test input ****)
+M103 T1 (disable extruder)
+M73 P0 (enable build progress)
+G21 (set units to mm)
+G90 (set positioning to absolute)
+M109 S110 T0 (set HBP temperature)
+M104 S230 T1 (set extruder temperature)
+(**** end of start.gcode ****)
+M108 R3.0 T1 (set extruder speed)
+M6 T1 (wait for toolhead parts, nozzle, HBP, etc., to reach temperature)
+G1 X-10.0 Y-10.0 Z0.2 F3300.0 (move to waiting position)
+G92 E0 (reset extruder)
+(<layer> 0.200 )
+G1 X17.600 Y19.317 Z0.200 F3000.0
+M101 T1 (extruder on, forward)
+G1 X-27.791 Y-21.265 Z0.200 F3063.2 E1.15521
+G1 X-10.837 Y-28.687 Z0.200 F2653.1 E2.27073
+G1 X24.634 Y2.355 Z0.200 F995.7 E3.58586
+G1 X13.733 Y9.774 Z0.200 F3162.2 E4.65017
+M108 R2.3 T1
+G1 X-8.272 Y-5.403 Z0.200 F1652.0 E6.13601
+G1 X12.045 Y17.785 Z0.200 F1009.7 E7.28159
+M108 R3.7 T1
+G1 X24.761 Y-0.798 Z0.200 F4097.4 E8.53205
+G1 X28.202 Y23.545 Z0.200 F2715.5 E9.41708
+G1 X-15.306 Y-4.219 Z0.200 F2101.0 E10.38562
+M108 R2.5 T1
+G1 X-18.052 Y6.493 Z0.200 F1725.1 E11.41962
+G1 X-16.636 Y5.841 Z0.200 F4102.8 E12.02034
+M103 T1 (extruder off)
+(<layer> 0.400 )
+G1 X1.328 Y-18.675 Z0.400 F3000.0
+M101 T1 (extruder on, forward)
+G1 X-10.025 Y24.266 Z0.400 F3205.1 E12.09507
+G1 X-6.650 Y-22.390 Z0.400 F4799.5 E12.69231
+M108 R2.3 T1
+G1 X-6.134 Y28.858 Z0.400 F1630.3 E13.82446
+G1 X10.213 Y23.371 Z0.400 F2478.2 E15.16824
+G1 X1.001 Y-1.744 Z0.400 F3563.8 E16.37258
+G1 X14.791 Y-14.051 Z0.400 F2648.2 E16.54718
+G1 X-28.688 Y-22.590 Z0.400 F3075.5 E16.84677
+G1 X-2.908 Y25.656 Z0.400 F1670.0 E17.26842
+G1 X6.731 Y-13.924 Z0.400 F2593.8 E18.59339
+M103 T1 (extruder off)
+(<layer> 0.600 )
+G1 X-21.469 Y-7.351 Z0.600 F3000.0
+M101 T1 (extruder on, forward)
+G1 X-1.964 Y-8.011 Z0.600 F1284.7 E19.56337
+G1 X11.667 Y-14.052 Z0.600 F3313.6 E20.51157
+G1 X-20.509 Y19.661 Z0.600 F2951.4 E21.61906
+G1 X-19.045 Y6.598 Z0.600 F2993.0 E23.06781
+G1 X28.956 Y-0.154 Z0.600 F3076.9 E23.65562
+G1 X-13.845 Y-29.111 Z0.600 F3986.1 E23.92948
+G1 X-25.451 Y-16.076 Z0.600 F2157.8 E24.74053
+G1 X-15.398 Y-10.900 Z0.600 F758.3 E25.77785
+G1 X-27.284 Y-1.327 Z0.600 F3641.2 E26.86306
+M108 R1.1 T1
+G1 X6.997 Y25.451 Z0.600 F1276.4 E27.71262
+M103 T1 (extruder off)
+(<layer> 0.800 )
+G1 X-14.089 Y20.305 Z0.800 F3000.0
+M101 T1 (extruder on, forward)
+G1 X11.628 Y17.480 Z0.800 F1175.7 E28.41800
+G1 X-3.547 Y16.710 Z0.800 F2477.7 E29.78572
+G1 X-26.180 Y18.012 Z0.800 F4707.9 E30.86882
+G1 X-24.979 Y21.485 Z0.800 F1775.2 E32.28134
+G1 X25.330 Y-28.085 Z0.800 F959.7 E32.95585
+G1 X2.130 Y-28.037 Z0.800 F1327.8 E33.93178
+G1 X29.582 Y15.912 Z0.800 F4589.1 E34.05728
+G1 X-25.344 Y13.891 Z0.800 F1078.9 E34.60532
+G1 X-0.328 Y-25.489 Z0.800 F910.7 E35.32820
+G1 X1.525 Y-20.982 Z0.800 F1783.2 E35.42239
+G1 X-6.701 Y-16.615 Z0.800 F1530.7 E36.29662
+G1 X-4.852 Y-20.209 Z0.800 F1929.3 E37.66696
+G1 X17.185 Y4.135 Z0.800 F1390.2 E38.54689
+M103 T1 (extruder off)
+G92 E0 (reset extruder)
+(<layer> 1.000 )
+G1 X-7.135 Y-3.543 Z1.000 F3000.0
+M101 T1 (extruder on, forward)
+G1 X1.847 Y21.002 Z1.000 F1172.3 E1.27506
+G1 X14.573 Y-13.686 Z1.000 F1377.6 E2.11375
+M108 R3.1 T1
+G1 X-25.543 Y-29.265 Z1.000 F2583.3 E2.35854
+M108 R3.0 T1
+G1 X10.424 Y5.737 Z1.000 F851.5 E3.19194
+G1 X15.819 Y11.261 Z1.000 F4594.6 E3.83186
+M108 R1.2 T1
+G1 X-26.471 Y23.625 Z1.000 F2439.3 E4.71330
+G1 X-19.332 Y11.038 Z1.000 F727.6 E5.78113
+G1 X-4.480 Y12.499 Z1.000 F1673.9 E7.27124
+G1 X9.257 Y2.136 Z1.000 F3307.8 E8.50417
+G1 X1.622 Y13.910 Z1.000 F4690.1 E8.57319
+G1 X-10.141 Y1.045 Z1.000 F3056.5 E9.88668
+M103 T1 (extruder off)
+M104 S225 T1
+(<layer> 1.200 )
+G1 X-8.277 Y11.478 Z1.200 F3000.0
+M101 T1 (extruder on, forward)
+G1 X-28.319 Y25.279 Z1.200 F4581.1 E11.31196
+G1 X-26.895 Y-21.636 Z1.200 F641.3 E12.56904
+M108 R1.0 T1
+G1 X-24.749 Y5.444 Z1.200 F1747.6 E13.82012
+M108 R2.3 T1
+G1 X28.631 Y-6.966 Z1.200 F3094.0 E14.13379
+G1 X-1.174 Y-13.791 Z1.200 F1174.4 E15.09275
+G1 X-3.095 Y18.502 Z1.200 F3019.4 E15.42192
+G1 X0.814 Y-22.805 Z1.200 F3089.3 E16.64574
+G1 X1.848 Y11.656 Z1.200 F4008.8 E17.94529
+G1 X23.961 Y-20.739 Z1.200 F4460.4 E19.21604
+M103 T1 (extruder off)
+(<layer> 1.400 )
+G1 X21.300 Y-9.734 Z1.400 F3000.0
+M101 T1 (extruder on, forward)
+G1 X-12.853 Y5.301 Z1.400 F3450.1 E19.72911
+G1 X-19.401 Y-5.541 Z1.400 F3205.4 E20.91015
+G1 X-18.346 Y-5.290 Z1.400 F3763.0 E21.89118
+G1 X25.727 Y-26.979 Z1.400 F2804.4 E22.15511
+G1 X22.978 Y-10.278 Z1.400 F3592.1 E23.54072
+G1 X9.827 Y28.017 Z1.400 F1698.6 E23.98658
+M108 R2.8 T1
+G1 X29.354 Y19.198 Z1.400 F2727.3 E24.92312
+G1 X28.060 Y-24.810 Z1.400 F4097.7 E26.08304
+G1 X-9.699 Y28.414 Z1.400 F4038.1 E26.44641
+G1 X-16.465 Y-22.470 Z1.400 F2612.1 E27.89582
+M103 T1 (extruder off)
+(<layer> 1.600 )
+G1 X7.340 Y13.587 Z1.600 F3000.0
+M101 T1 (extruder on, forward)
+G1 X18.227 Y4.314 Z1.600 F3682.7 E28.60638
+G1 X24.700 Y-13.562 Z1.600 F606.4 E29.56406
+G1 X29.618 Y-2.655 Z1.600 F857.4 E29.65738
+G1 X-6.956 Y7.430 Z1.600 F1028.1 E30.75328
+G1 X19.967 Y-21.162 Z1.600 F3402.7 E31.34435
+G1 X-28.840 Y1.903 Z1.600 F4119.8 E31.98076
+M108 R2.3 T1
+G1 X29.647 Y28.171 Z1.600 F3449.3 E32.04882
+G1 X-22.736 Y12.300 Z1.600 F3936.9 E32.20087
+G1 X-3.725 Y-14.682 Z1.600 F2875.7 E33.50037
+M103 T1 (extruder off)
+M73 P100 (end build progress )
+M104 S0 T1 (turn off extruder)
+M109 S0 T0 (turn off HBP)
+(**** end of end.gcode ****)
@@ -0,0 +1,134 @@
+(**** This is a build header ****)
+(**** Generated by MakerWare style test input ****)
+M103 T1 (disable extruder)
+M73 P0 (enable build progress)
+G21 (set units to mm)
+G90 (set positioning to absolute)
+M109 S110 T0 (set HBP temperature)
+M104 S230 T1 (set extruder temperature)
+(**** end of start.gcode ****)
+M108 R3.0 T1 (set extruder speed)
+M6 T1 (wait for toolhead parts, nozzle, HBP, etc., to reach temperature)
+G1 X-10.0 Y-10.0 Z0.2 F3300.0 (move to waiting position)
+(<layer> 0.200 )
+G1 X27.362 Y26.870 Z0.200 F3000.0
+M101 T1 (extruder on, forward)
+G1 X-8.337 Y-19.855 Z0.200 F3997.6 E0.18280
+G1 X-17.267 Y-27.856 Z0.200 F3461.2 E0.59759
+G1 X18.220 Y21.615 Z0.200 F2738.1 E1.57338
+G1 X0.124 Y24.072 Z0.200 F4258.3 E2.98016
+G1 X24.465 Y-4.583 Z0.200 F4313.1 E4.38134
+G1 X-16.164 Y-19.397 Z0.200 F1329.1 E4.68862
+G1 X0.824 Y3.593 Z0.200 F4779.7 E5.26017
+G1 X1.522 Y24.509 Z0.200 F2129.9 E5.91144
+M103 T1 (extruder off)
+(<layer> 0.400 )
+G1 X-8.287 Y21.538 Z0.400 F3000.0
+M101 T1 (extruder on, forward)
+G1 X15.240 Y12.909 Z0.400 F2537.9 E6.19516
+G1 X25.490 Y0.050 Z0.400 F4092.4 E6.95568
+G1 X23.982 Y-2.339 Z0.400 F2984.4 E8.28582
+G1 X-0.803 Y-16.691 Z0.400 F1963.6 E9.38529
+G1 X24.476 Y-13.912 Z0.400 F4427.8 E9.67609
+G1 X12.372 Y0.255 Z0.400 F2774.5 E11.11426
+G1 X-11.289 Y-17.531 Z0.400 F2749.9 E12.01678
+G1 X-25.477 Y19.224 Z0.400 F3649.0 E12.97052
+G1 X14.687 Y-26.474 Z0.400 F3342.2 E13.29805
+G1 X22.529 Y-23.624 Z0.400 F2793.9 E13.67665
+G1 X-17.371 Y22.835 Z0.400 F2376.3 E14.08165
+M103 T1 (extruder off)
+(<layer> 0.600 )
+G1 X-28.088 Y-8.259 Z0.600 F3000.0
+M101 T1 (extruder on, forward)
+G1 X-28.593 Y-23.087 Z0.600 F883.4 E14.49343
+M108 R3.8 T1
+G1 X-22.333 Y26.158 Z0.600 F3686.1 E15.08442
+G1 X5.367 Y17.649 Z0.600 F1640.9 E15.13723
+G1 X26.308 Y7.665 Z0.600 F3740.2 E15.19331
+G1 X-11.497 Y3.090 Z0.600 F3141.7 E15.95202
+M108 R1.8 T1
+G1 X7.296 Y-20.793 Z0.600 F4626.9 E16.58470
+M108 R3.1 T1
+G1 X-28.548 Y17.305 Z0.600 F4582.0 E17.85039
+G1 X-0.785 Y-10.322 Z0.600 F4272.7 E19.03292
+G1 X28.241 Y9.199 Z0.600 F3537.8 E19.46259
+M103 T1 (extruder off)
+(<layer> 0.800 )
+G1 X10.234 Y-14.822 Z0.800 F3000.0
+M101 T1 (extruder on, forward)
+G1 X-24.248 Y8.105 Z0.800 F2734.7 E19.74628
+G1 X29.672 Y-16.052 Z0.800 F2467.7 E21.15076
+G1 X7.450 Y18.012 Z0.800 F3579.9 E22.05806
+G1 X1.571 Y-29.711 Z0.800 F749.1 E22.72143
+G1 X13.426 Y-15.548 Z0.800 F1019.0 E22.93264
+G1 X-16.959 Y1.244 Z0.800 F2550.5 E23.31835
+G1 X-17.253 Y24.394 Z0.800 F4645.1 E24.29890
+G1 X0.690 Y4.865 Z0.800 F815.2 E24.97781
+G1 X-19.126 Y-24.373 Z0.800 F3971.2 E25.78916
+M103 T1 (extruder off)
+(<layer> 1.000 )
+G1 X1.153 Y25.287 Z1.000 F3000.0
+M101 T1 (extruder on, forward)
+G1 X11.424 Y25.947 Z1.000 F1894.8 E0.58140
+G1 X-23.699 Y-18.097 Z1.000 F3856.4 E1.22917
+G1 X-26.401 Y8.238 Z1.000 F2546.0 E2.45666
+G1 X-29.680 Y-28.551 Z1.000 F1884.4 E3.39631
+G1 X-0.573 Y-23.054 Z1.000 F2168.3 E3.76410
+G1 X-9.304 Y23.262 Z1.000 F1667.5 E4.01662
+M108 R2.8 T1
+G1 X-6.534 Y-17.279 Z1.000 F1042.7 E4.55162
+G1 X-27.409 Y12.348 Z1.000 F1821.2 E5.28366
+G1 X-7.505 Y-0.948 Z1.000 F4236.3 E5.53879
+G1 X-4.862 Y-0.473 Z1.000 F3456.9 E6.64426
+G1 X5.793 Y2.914 Z1.000 F3521.6 E6.92104
+G1 X13.668 Y4.545 Z1.000 F898.9 E7.09329
+M103 T1 (extruder off)
+M104 S225 T1
+(<layer> 1.200 )
+G1 X2.716 Y18.378 Z1.200 F3000.0
+M101 T1 (extruder on, forward)
+G1 X24.682 Y10.881 Z1.200 F4001.2 E8.30122
+M108 R3.9 T1
+G1 X12.504 Y23.109 Z1.200 F1983.5 E8.91758
+G1 X-20.639 Y29.201 Z1.200 F4669.2 E9.38371
+G1 X-15.084 Y0.850 Z1.200 F1312.2 E9.91054
+G1 X-15.933 Y22.468 Z1.200 F2105.9 E11.33425
+G1 X-2.000 Y13.132 Z1.200 F4000.9 E12.44119
+G1 X-6.429 Y-26.786 Z1.200 F1750.6 E13.55948
+G1 X-5.271 Y8.876 Z1.200 F2112.4 E14.66979
+M103 T1 (extruder off)
+(<layer> 1.400 )
+G1 X12.796 Y24.718 Z1.400 F3000.0
+M101 T1 (extruder on, forward)
+G1 X21.124 Y-16.500 Z1.400 F3209.2 E15.82412
+G1 X28.634 Y8.090 Z1.400 F648.7 E16.84123
+G1 X22.993 Y9.005 Z1.400 F4027.5 E17.92302
+M108 R3.8 T1
+G1 X6.387 Y24.319 Z1.400 F4315.7 E19.03074
+M108 R3.4 T1
+G1 X-18.028 Y14.655 Z1.400 F3062.2 E20.19289
+G1 X-21.728 Y6.739 Z1.400 F2424.5 E21.40896
+G1 X-1.975 Y-17.700 Z1.400 F4660.5 E22.27980
+M108 R1.0 T1
+G1 X20.231 Y9.504 Z1.400 F3769.6 E23.03367
+M103 T1 (extruder off)
+(<layer> 1.600 )
+G1 X10.488 Y-9.907 Z1.600 F3000.0
+M101 T1 (extruder on, forward)
+G1 X-2.381 Y29.225 Z1.600 F3176.6 E24.35607
+G1 X26.311 Y29.864 Z1.600 F1672.2 E25.50753
+G1 X13.174 Y-26.755 Z1.600 F2697.8 E26.76601
+G1 X-20.649 Y-13.041 Z1.600 F2563.0 E27.79574
+M108 R1.1 T1
+G1 X3.858 Y-17.735 Z1.600 F3441.0 E29.07829
+G1 X11.378 Y12.666 Z1.600 F1871.4 E29.32170
+G1 X-9.978 Y26.904 Z1.600 F1911.1 E29.82566
+G1 X25.230 Y0.508 Z1.600 F1484.6 E30.62689
+G1 X-21.028 Y0.280 Z1.600 F974.4 E31.90671
+M108 R3.8 T1
+G1 X1.358 Y-26.324 Z1.600 F1070.0 E32.77060
+M103 T1 (extruder off)
+M73 P100 (end build progress )
+M104 S0 T1 (turn off extruder)
+M109 S0 T0 (turn off HBP)
+(**** end of end.gcode ****)
@@ -0,0 +1,152 @@
+(**** This is a build header ****)
+(**** Generated by MakerWare style test input ****)
+M103 T1 (disable extruder)
+M73 P0 (enable build progress)
+G21 (set units to mm)
+G90 (set positioning to absolute)
+M109 S110 T0 (set HBP temperature)
+M104 S230 T1 (set extruder temperature)
+(**** end of start.gcode ****)
+; long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line long comment line 
+M108 R3.0 T1 (set extruder speed)
+M6 T1 (wait for toolhead parts, nozzle, HBP, etc., to reach temperature)
+G1 X-10.0 Y-10.0 Z0.2 F3300.0 (move to waiting position)
+(<layer> 0.200 )
+G1 X7.374 Y14.507 Z0.200 F3000.0
+M101 T1 (extruder on, forward)
+G1 X20.491 Y9.122 Z0.200 F2826.2 E1.05115
+G1 X-15.057 Y-26.889 Z0.200 F1258.8 E2.22629
+G1 X-7.155 Y-23.882 Z0.200 F1647.2 E3.53553
+G1 X-19.075 Y22.048 Z0.200 F2235.6 E4.17735
+G1 X-19.075 Y22.048 Z0.200 F2235.6 E4.17735                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                (trailing comment xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx)
+G1 X7.076 Y-3.310 Z0.200 F1155.4 E4.33165
+G1 X16.416 Y27.608 Z0.200 F1296.6 E4.38936
+G1 X-18.067 Y22.567 Z0.200 F3228.1 E4.89415
+G1 X-18.187 Y27.906 Z0.200 F2209.5 E6.34856
+M108 R2.2 T1
+G1 X-14.171 Y-10.089 Z0.200 F4033.1 E7.75546
+G1 X12.461 Y-26.039 Z0.200 F2092.5 E8.66963
+G1 X-18.914 Y-1.648 Z0.200 F1339.7 E9.72944
+G1 X26.953 Y-8.541 Z0.200 F2298.0 E11.14100
+G1 X-7.418 Y20.474 Z0.200 F2501.9 E11.79830
+G1 X27.264 Y-22.859 Z0.200 F1633.6 E12.75269
+M103 T1 (extruder off)
+(<layer> 0.400 )
+G1 X-2.268 Y0.750 Z0.400 F3000.0
+M101 T1 (extruder on, forward)
+G1 X-2.229 Y5.386 Z0.400 F3880.1 E13.16648
+G1 X-4.021 Y28.700 Z0.400 F1475.6 E13.64549
+G1 X-21.108 Y-13.459 Z0.400 F3550.9 E14.22129
+M108 R3.1 T1
+G1 X17.926 Y7.608 Z0.400 F3628.8 E14.71524
+G1 X13.208 Y-25.143 Z0.400 F3122.7 E15.46674
+G1 X14.434 Y-9.370 Z0.400 F1650.9 E15.56289
+G1 X28.743 Y8.299 Z0.400 F3967.0 E15.82405
+G1 X28.878 Y3.843 Z0.400 F1157.7 E16.17429
+G1 X-19.871 Y-7.620 Z0.400 F846.8 E16.82433
+G1 X25.320 Y7.224 Z0.400 F1311.0 E17.07908
+G1 X11.330 Y-10.938 Z0.400 F1750.9 E18.52127
+G1 X-23.246 Y19.323 Z0.400 F2833.4 E19.87896
+M103 T1 (extruder off)
+(<layer> 0.600 )
+G1 X26.229 Y22.068 Z0.600 F3000.0
+M101 T1 (extruder on, forward)
+G1 X-13.661 Y16.921 Z0.600 F4243.0 E20.05821
+G1 X16.494 Y11.676 Z0.600 F3388.9 E21.24795
+G1 X12.268 Y-13.149 Z0.600 F2639.9 E21.82492
+G1 X-12.369 Y26.733 Z0.600 F3328.7 E22.87670
+G1 X2.819 Y-14.958 Z0.600 F3420.9 E22.94349
+G1 X8.846 Y17.858 Z0.600 F2061.1 E24.17768
+G1 X19.691 Y-8.997 Z0.600 F4140.1 E25.29753
+G1 X28.567 Y27.391 Z0.600 F2776.2 E26.34562
+G1 X20.197 Y26.243 Z0.600 F2604.4 E26.63657
+M103 T1 (extruder off)
+(<layer> 0.800 )
+G1 X13.181 Y13.821 Z0.800 F3000.0
+M101 T1 (extruder on, forward)
+G1 X26.173 Y0.987 Z0.800 F4533.0 E27.58090
+G1 X22.028 Y-13.758 Z0.800 F4783.3 E28.43305
+G1 X7.444 Y-19.155 Z0.800 F3787.8 E29.33340
+G1 X29.188 Y28.786 Z0.800 F1296.1 E30.42517
+G1 X28.079 Y-1.040 Z0.800 F2902.9 E30.63587
+G1 X9.751 Y-25.681 Z0.800 F1458.3 E31.19497
+G1 X-8.969 Y27.126 Z0.800 F4194.6 E31.78728
+G1 X2.835 Y27.862 Z0.800 F2909.7 E32.83612
+G1 X0.759 Y27.066 Z0.800 F1831.4 E33.31428
+M103 T1 (extruder off)
+(<layer> 1.000 )
+G1 X-22.250 Y-5.445 Z1.000 F3000.0
+M101 T1 (extruder on, forward)
+G1 X-7.833 Y-21.473 Z1.000 F3102.9 E0.98133
+G1 X28.080 Y6.517 Z1.000 F2074.7 E2.41929
+G1 X-23.525 Y3.949 Z1.000 F3183.7 E2.47066
+M108 R2.9 T1
+G1 X-7.449 Y-4.099 Z1.000 F1550.6 E3.81302
+G1 X-7.213 Y27.668 Z1.000 F4437.7 E5.27308
+G1 X28.859 Y-0.222 Z1.000 F2345.1 E5.69983
+G1 X-0.495 Y-12.816 Z1.000 F2603.1 E7.17703
+M108 R2.9 T1
+G1 X-12.414 Y16.902 Z1.000 F4072.6 E7.87005
+M108 R2.6 T1
+G1 X26.115 Y16.914 Z1.000 F1631.8 E8.31705
+G1 X29.330 Y-12.409 Z1.000 F3153.8 E8.59146
+G1 X6.231 Y14.608 Z1.000 F1096.4 E9.57653
+G1 X2.010 Y-9.833 Z1.000 F1846.7 E10.06253
+M103 T1 (extruder off)
+M104 S225 T1
+(<layer> 1.200 )
+G1 X-2.140 Y-8.338 Z1.200 F3000.0
+M101 T1 (extruder on, forward)
+G1 X-22.051 Y-29.830 Z1.200 F2923.6 E11.29085
+G1 X11.245 Y-18.529 Z1.200 F2404.6 E11.49687
+G1 X11.341 Y27.196 Z1.200 F3325.2 E12.40947
+G1 X-1.457 Y10.940 Z1.200 F3622.4 E13.67921
+G1 X15.492 Y-11.781 Z1.200 F613.6 E14.40358
+G1 X8.904 Y-1.653 Z1.200 F1906.0 E15.29764
+G1 X23.321 Y28.375 Z1.200 F2859.4 E16.35573
+G1 X-27.087 Y13.958 Z1.200 F1722.3 E17.19077
+M108 R1.2 T1
+G1 X-10.017 Y-4.240 Z1.200 F888.6 E18.60691
+G1 X-22.597 Y-22.659 Z1.200 F3181.1 E19.36261
+G1 X23.691 Y29.643 Z1.200 F3564.3 E19.57379
+G1 X-18.883 Y18.123 Z1.200 F882.4 E19.88926
+G1 X9.613 Y14.732 Z1.200 F1775.5 E20.74476
+M103 T1 (extruder off)
+(<layer> 1.400 )
+G1 X-22.899 Y-6.088 Z1.400 F3000.0
+M101 T1 (extruder on, forward)
+G1 X-4.100 Y-11.126 Z1.400 F3120.9 E20.98954
+G1 X-7.548 Y-26.655 Z1.400 F3528.6 E22.40042
+G1 X0.351 Y24.625 Z1.400 F2930.5 E23.36587
+G1 X3.101 Y-14.749 Z1.400 F3752.4 E23.79758
+G1 X-15.935 Y-7.727 Z1.400 F3694.4 E24.04156
+G1 X9.301 Y-24.885 Z1.400 F3405.4 E25.12584
+M108 R1.4 T1
+G1 X-15.685 Y22.616 Z1.400 F2618.0 E26.03710
+G1 X-28.232 Y13.500 Z1.400 F825.4 E27.24197
+G1 X10.867 Y-16.615 Z1.400 F1087.5 E28.67243
+G1 X19.236 Y-21.614 Z1.400 F3224.1 E29.68678
+G1 X-10.004 Y6.825 Z1.400 F2064.4 E30.07755
+G1 X19.866 Y8.873 Z1.400 F3978.9 E30.32537
+M103 T1 (extruder off)
+(<layer> 1.600 )
+G1 X21.095 Y1.049 Z1.600 F3000.0
+M101 T1 (extruder on, forward)
+G1 X-17.107 Y-19.168 Z1.600 F865.8 E31.81532
+M108 R1.6 T1
+G1 X-0.598 Y26.227 Z1.600 F3377.2 E32.14894
+G1 X-11.967 Y26.076 Z1.600 F4471.2 E32.81807
+G1 X-18.504 Y9.202 Z1.600 F899.0 E33.53782
+G1 X-1.820 Y3.124 Z1.600 F1063.0 E34.84775
+G1 X10.319 Y-28.011 Z1.600 F4364.7 E35.98579
+G1 X-11.036 Y-26.466 Z1.600 F691.3 E37.12618
+G1 X-20.642 Y17.121 Z1.600 F1962.0 E38.40694
+G1 X29.616 Y-27.988 Z1.600 F3602.2 E38.80487
+G1 X7.055 Y24.700 Z1.600 F3568.2 E39.80675
+G1 X-8.312 Y-25.987 Z1.600 F4773.2 E40.12424
+G1 X-19.461 Y-17.474 Z1.600 F784.5 E41.29921
+M103 T1 (extruder off)
+M73 P100 (end build progress )
+M104 S0 T1 (turn off extruder)
+M109 S0 T0 (turn off HBP)
+(**** end of end.gcode ****)
@@ -0,0 +1,142 @@
+(**** This is a build header ****)
+(**** Generated by MakerWare style test input ****)
+M103 T0 (disable extruder)
+M73 P0 (enable build progress)
+G21 (set units to mm)
+G90 (set positioning to absolute)
+M109 S110 T0 (set HBP temperature)
+M104 S230 T0 (set extruder temperature)
+(**** end of start.gcode ****)
+M108 R3.0 T0 (set extruder speed)
+M6 T0 (wait for toolhead parts, nozzle, HBP, etc., to reach temperature)
+G1 X-10.0 Y-10.0 Z0.2 F3300.0 (move to waiting position)
+G92 E0 (reset extruder)
+M83 (relative extrusion)
+(<layer> 0.200 )
+G1 X-15.837 Y-23.810 Z0.200 F3000.0
+M101 T0 (extruder on, forward)
+G1 X-24.594 Y-28.811 Z0.200 F2907.5 E0.74437
+G1 X-26.469 Y1.220 Z0.200 F2113.0 E1.48554
+G1 X-14.297 Y26.578 Z0.200 F707.7 E1.24896
+G1 X-13.695 Y-20.111 Z0.200 F1816.5 E0.42737
+G1 X20.912 Y-7.656 Z0.200 F4148.1 E1.44334
+G1 X-15.068 Y-15.161 Z0.200 F1776.0 E0.61250
+G1 X26.532 Y20.428 Z0.200 F630.3 E1.23593
+G1 X-11.294 Y15.912 Z0.200 F1419.5 E1.07212
+G1 X-2.918 Y-16.006 Z0.200 F1690.6 E0.46790
+G1 X-2.240 Y29.848 Z0.200 F2779.3 E0.16756
+G1 X-21.296 Y10.427 Z0.200 F879.0 E1.06627
+M103 T0 (extruder off)
+(<layer> 0.400 )
+G1 X8.101 Y-3.531 Z0.400 F3000.0
+M101 T0 (extruder on, forward)
+G1 X14.817 Y-10.760 Z0.400 F2945.8 E0.56595
+G1 X-26.303 Y-16.268 Z0.400 F3813.7 E0.19642
+G1 X-10.136 Y-19.348 Z0.400 F2527.9 E0.39425
+M108 R3.1 T0
+G1 X27.284 Y14.093 Z0.400 F4631.4 E1.34910
+M108 R1.9 T0
+G1 X16.514 Y-5.374 Z0.400 F4561.9 E1.45071
+G1 X-12.395 Y-18.515 Z0.400 F2465.4 E1.23600
+M108 R2.1 T0
+G1 X-10.122 Y-29.436 Z0.400 F788.1 E1.44463
+G1 X-8.237 Y-12.580 Z0.400 F1007.8 E1.18643
+G1 X-17.525 Y-26.440 Z0.400 F832.1 E0.66473
+M103 T0 (extruder off)
+(<layer> 0.600 )
+G1 X10.610 Y-21.022 Z0.600 F3000.0
+M101 T0 (extruder on, forward)
+G1 X4.960 Y-10.714 Z0.600 F749.4 E0.84203
+G1 X29.814 Y9.097 Z0.600 F1441.1 E0.47472
+G1 X-0.484 Y-16.856 Z0.600 F2462.7 E0.68628
+G1 X-17.057 Y-18.737 Z0.600 F754.6 E0.67036
+G1 X16.339 Y-4.972 Z0.600 F1699.1 E0.81223
+G1 X-11.129 Y-22.989 Z0.600 F2992.8 E1.34199
+G1 X22.254 Y13.041 Z0.600 F770.1 E0.99680
+G1 X25.796 Y4.338 Z0.600 F4565.4 E0.67366
+M103 T0 (extruder off)
+(<layer> 0.800 )
+G1 X-12.228 Y-1.726 Z0.800 F3000.0
+M101 T0 (extruder on, forward)
+G1 X-4.801 Y-17.086 Z0.800 F3965.9 E0.50680
+G1 X-6.469 Y-0.217 Z0.800 F4206.2 E0.54087
+G1 X-18.525 Y-6.312 Z0.800 F3202.1 E0.96040
+G1 X21.379 Y22.205 Z0.800 F3489.0 E0.44069
+G1 X-5.776 Y-6.573 Z0.800 F3951.7 E0.73467
+G1 X6.601 Y-14.560 Z0.800 F2262.3 E0.27728
+G1 X-16.660 Y-26.796 Z0.800 F4594.0 E0.60257
+G1 X19.106 Y3.742 Z0.800 F3894.2 E0.93200
+G1 X-25.261 Y11.726 Z0.800 F1074.2 E0.68748
+G1 X16.447 Y-27.517 Z0.800 F934.7 E0.42258
+G1 X-12.184 Y-9.185 Z0.800 F913.9 E1.36230
+G1 X-17.679 Y28.594 Z0.800 F2232.2 E0.70797
+G1 X-5.997 Y-25.368 Z0.800 F4446.2 E1.29044
+M103 T0 (extruder off)
+(<layer> 1.000 )
+G1 X-8.047 Y29.975 Z1.000 F3000.0
+M101 T0 (extruder on, forward)
+G1 X16.595 Y-25.985 Z1.000 F4301.6 E1.29387
+G1 X20.187 Y-4.652 Z1.000 F3953.1 E0.48834
+G1 X-19.419 Y-21.042 Z1.000 F2675.9 E1.31772
+G1 X24.244 Y12.631 Z1.000 F623.4 E0.83570
+G1 X-0.810 Y12.935 Z1.000 F2633.8 E0.84018
+M108 R1.7 T0
+G1 X-8.593 Y16.000 Z1.000 F4740.4 E1.27898
+G1 X6.572 Y-11.204 Z1.000 F4433.7 E1.03126
+G1 X-11.661 Y22.052 Z1.000 F3904.8 E1.37154
+G1 X-21.560 Y16.263 Z1.000 F2121.2 E0.69099
+G1 X-25.046 Y-21.364 Z1.000 F3997.9 E0.24322
+G1 X-7.681 Y4.559 Z1.000 F2071.9 E1.35777
+M103 T0 (extruder off)
+M104 S225 T0
+(<layer> 1.200 )
+G1 X-24.392 Y-5.847 Z1.200 F3000.0
+M101 T0 (extruder on, forward)
+G1 X-7.686 Y-19.523 Z1.200 F4309.8 E0.52799
+G1 X15.272 Y-24.678 Z1.200 F2107.9 E0.80971
+G1 X-19.056 Y29.222 Z1.200 F3376.2 E0.19268
+G1 X25.542 Y29.183 Z1.200 F1322.5 E0.16150
+G1 X-16.670 Y17.201 Z1.200 F3373.1 E1.33517
+G1 X22.862 Y-15.754 Z1.200 F2657.3 E1.04725
+G1 X14.740 Y2.234 Z1.200 F2825.0 E0.58304
+G1 X0.377 Y28.171 Z1.200 F1915.1 E1.21413
+G1 X-14.923 Y23.843 Z1.200 F2525.8 E0.90279
+M103 T0 (extruder off)
+(<layer> 1.400 )
+G1 X19.560 Y-5.748 Z1.400 F3000.0
+M101 T0 (extruder on, forward)
+G1 X-20.637 Y-25.937 Z1.400 F4689.9 E0.95368
+G1 X6.228 Y-11.266 Z1.400 F983.6 E1.38395
+G1 X25.695 Y23.554 Z1.400 F3867.3 E0.37213
+M108 R1.7 T0
+G1 X26.876 Y-20.201 Z1.400 F3919.9 E0.48386
+G1 X27.558 Y-14.260 Z1.400 F2802.3 E0.84335
+G1 X-28.095 Y-11.009 Z1.400 F1111.4 E0.19031
+M108 R4.0 T0
+G1 X23.414 Y12.119 Z1.400 F3671.6 E0.46913
+G1 X22.709 Y13.166 Z1.400 F2951.8 E1.43129
+G1 X3.141 Y0.153 Z1.400 F1247.6 E1.09937
+G1 X-25.932 Y-19.918 Z1.400 F4274.1 E0.75208
+G1 X10.928 Y21.696 Z1.400 F1979.4 E0.61742
+M103 T0 (extruder off)
+(<layer> 1.600 )
+G1 X-4.615 Y-28.317 Z1.600 F3000.0
+M101 T0 (extruder on, forward)
+G1 X27.606 Y-20.849 Z1.600 F1258.0 E0.07755
+G1 X-16.079 Y3.212 Z1.600 F2602.2 E1.24393
+G1 X19.529 Y29.786 Z1.600 F3567.1 E0.31839
+G1 X-7.233 Y20.850 Z1.600 F4101.8 E1.40883
+G1 X7.155 Y24.704 Z1.600 F1881.6 E0.20539
+G1 X6.006 Y-27.766 Z1.600 F3254.2 E1.35089
+G1 X9.717 Y-11.556 Z1.600 F4361.7 E1.29405
+G1 X20.050 Y23.497 Z1.600 F4351.4 E0.54176
+G1 X11.924 Y6.281 Z1.600 F2813.8 E1.00459
+G1 X-25.109 Y12.811 Z1.600 F2692.0 E0.56194
+G1 X-15.008 Y-17.949 Z1.600 F899.6 E0.91692
+G1 X11.803 Y-22.993 Z1.600 F4709.8 E1.36727
+G1 X-29.946 Y20.631 Z1.600 F3218.1 E0.78849
+M103 T0 (extruder off)
+M73 P100 (end build progress )
+M104 S0 T0 (turn off extruder)
+M109 S0 T0 (turn off HBP)
+(**** end of end.gcode ****)
@@ -0,0 +1,151 @@
+(**** This is a build header ****)
+(**** Generated by MakerWare style test input ****)
+M103 T0 (disable extruder)
+M73 P0 (enable build progress)
+G21 (set units to mm)
+G90 (set positioning to absolute)
+M109 S110 T0 (set HBP temperature)
+M104 S230 T0 (set extruder temperature)
+(**** end of start.gcode ****)
+M108 R3.0 T0 (set extruder speed)
+M6 T0 (wait for toolhead parts, nozzle, HBP, etc., to reach temperature)
+G1 X-10.0 Y-10.0 Z0.2 F3300.0 (move to waiting position)
+(<layer> 0.200 )
+G1 X-21.938 Y20.846 Z0.200 F3000.0
+M101 T0 (extruder on, forward)
+G1 X-22.925 Y15.658 Z0.200 F2583.4 E0.14150
+G1 X-0.729 Y23.599 Z0.200 F2237.2 E0.49594
+G1 X11.750 Y-14.020 Z0.200 F3967.7 E1.65832
+G1 X-10.954 Y-28.661 Z0.200 F3328.1 E1.85655
+M108 R3.6 T0
+G1 X28.142 Y13.551 Z0.200 F2816.0 E2.90195
+G1 X3.172 Y-9.258 Z0.200 F3442.8 E4.31374
+G1 X25.590 Y-5.029 Z0.200 F4448.3 E5.74450
+G1 X7.761 Y13.418 Z0.200 F1844.8 E5.93950
+G1 X28.395 Y0.048 Z0.200 F4662.3 E7.28808
+G1 X-18.609 Y-12.950 Z0.200 F4688.5 E8.65785
+G1 X-6.399 Y21.197 Z0.200 F2617.0 E10.07217
+G1 X9.885 Y-7.973 Z0.200 F4307.5 E10.70839
+G1 X-24.812 Y9.825 Z0.200 F1053.3 E11.82880
+G1 X-7.769 Y13.966 Z0.200 F2571.1 E13.09673
+M103 T0 (extruder off)
+(<layer> 0.400 )
+G1 X20.898 Y6.889 Z0.400 F3000.0
+M101 T0 (extruder on, forward)
+G1 X-19.779 Y0.134 Z0.400 F4724.7 E13.71745
+G1 X21.617 Y-16.069 Z0.400 F2757.8 E14.54990
+G1 X-2.452 Y-13.843 Z0.400 F2901.6 E15.43770
+G1 X17.019 Y19.229 Z0.400 F4322.0 E15.49598
+G1 X1.121 Y3.681 Z0.400 F2389.6 E16.71923
+M108 R3.6 T0
+G1 X-18.010 Y0.283 Z0.400 F2636.7 E17.59573
+G1 X2.309 Y7.409 Z0.400 F3172.3 E18.14754
+G1 X-16.224 Y-19.367 Z0.400 F3054.7 E18.23811
+G1 X17.826 Y18.986 Z0.400 F1672.2 E19.44584
+G1 X-25.006 Y-28.999 Z0.400 F661.2 E20.47186
+G1 X-23.431 Y7.488 Z0.400 F2046.6 E20.88372
+M108 R1.5 T0
+G1 X-19.911 Y-13.625 Z0.400 F3588.7 E21.69842
+M103 T0 (extruder off)
+(<layer> 0.600 )
+G1 X-10.680 Y-1.574 Z0.600 F3000.0
+M101 T0 (extruder on, forward)
+G1 X-9.399 Y17.772 Z0.600 F1685.4 E22.20083
+G1 X28.604 Y27.934 Z0.600 F2413.0 E23.30955
+G1 X-6.161 Y-27.880 Z0.600 F4631.6 E23.68634
+G1 X-4.400 Y19.935 Z0.600 F4703.3 E24.47049
+G1 X-2.949 Y1.434 Z0.600 F728.9 E25.52831
+G1 X9.589 Y-4.422 Z0.600 F3697.3 E26.74322
+M108 R1.6 T0
+G1 X-25.756 Y-25.413 Z0.600 F4452.1 E26.86201
+G1 X3.896 Y-22.177 Z0.600 F2955.0 E27.14141
+M103 T0 (extruder off)
+(<layer> 0.800 )
+G1 X5.435 Y-16.945 Z0.800 F3000.0
+M101 T0 (extruder on, forward)
+G1 X19.675 Y22.193 Z0.800 F3876.1 E27.85965
+G1 X-17.976 Y-24.058 Z0.800 F3008.2 E27.96391
+G1 X-0.459 Y26.277 Z0.800 F2238.3 E28.87145
+G1 X6.728 Y-5.861 Z0.800 F1781.7 E28.94639
+G1 X18.668 Y3.800 Z0.800 F1167.6 E30.23982
+G1 X-24.216 Y-7.246 Z0.800 F2900.0 E30.67630
+G1 X2.060 Y16.077 Z0.800 F2836.6 E31.94095
+M108 R1.1 T0
+G1 X-20.007 Y2.293 Z0.800 F1725.6 E32.18383
+G1 X-14.683 Y-9.669 Z0.800 F1078.4 E32.96737
+G1 X16.772 Y12.907 Z0.800 F2652.9 E34.38616
+G1 X-10.756 Y-5.604 Z0.800 F2197.0 E35.55303
+G1 X-22.499 Y-23.119 Z0.800 F3067.1 E35.81665
+M103 T0 (extruder off)
+(<layer> 1.000 )
+G1 X-25.401 Y3.016 Z1.000 F3000.0
+M101 T0 (extruder on, forward)
+G1 X-13.997 Y23.446 Z1.000 F2970.7 E0.16853
+G1 X-13.369 Y17.221 Z1.000 F4076.6 E0.88229
+M108 R3.0 T0
+G1 X-23.094 Y23.104 Z1.000 F768.1 E1.06523
+G1 X-4.739 Y-23.067 Z1.000 F1303.0 E2.54806
+G1 X-23.830 Y24.646 Z1.000 F2188.8 E3.67687
+G1 X-12.359 Y-14.795 Z1.000 F2603.4 E5.04525
+M108 R3.0 T0
+G1 X-29.370 Y28.955 Z1.000 F1841.3 E5.15270
+G1 X-11.203 Y-26.222 Z1.000 F4436.2 E5.85497
+G1 X-23.318 Y-17.088 Z1.000 F3194.8 E7.31117
+G1 X11.291 Y9.710 Z1.000 F1688.2 E8.14840
+G1 X-15.217 Y-25.118 Z1.000 F1779.3 E8.64401
+G1 X9.121 Y8.608 Z1.000 F4551.1 E9.34347
+M103 T0 (extruder off)
+M104 S225 T0
+(<layer> 1.200 )
+G1 X-11.593 Y-10.366 Z1.200 F3000.0
+M101 T0 (extruder on, forward)
+G1 X4.740 Y25.281 Z1.200 F1632.6 E10.54293
+M108 R2.8 T0
+G1 X-24.477 Y-16.791 Z1.200 F3994.7 E11.76391
+G1 X22.053 Y13.750 Z1.200 F690.4 E12.20260
+M108 R3.3 T0
+G1 X-1.870 Y21.547 Z1.200 F1023.9 E12.77343
+G1 X0.556 Y9.915 Z1.200 F1354.2 E13.29916
+M108 R1.4 T0
+G1 X-11.663 Y12.559 Z1.200 F4105.7 E14.60420
+G1 X-17.596 Y2.730 Z1.200 F3635.0 E14.83734
+G1 X7.412 Y10.332 Z1.200 F2922.4 E16.07783
+G1 X-17.674 Y-12.064 Z1.200 F2857.5 E17.55889
+M108 R3.6 T0
+G1 X16.667 Y10.925 Z1.200 F2476.1 E17.96747
+M103 T0 (extruder off)
+(<layer> 1.400 )
+G1 X-14.987 Y-3.636 Z1.400 F3000.0
+M101 T0 (extruder on, forward)
+G1 X-6.257 Y-9.680 Z1.400 F1683.5 E18.67477
+M108 R2.9 T0
+G1 X4.236 Y-26.261 Z1.400 F2090.8 E19.32896
+M108 R1.4 T0
+G1 X19.736 Y-6.132 Z1.400 F2284.5 E19.75467
+G1 X-29.551 Y1.722 Z1.400 F2703.8 E20.14329
+G1 X11.191 Y13.885 Z1.400 F1601.2 E20.82885
+G1 X-16.496 Y-5.265 Z1.400 F2953.7 E21.57315
+G1 X-13.486 Y8.785 Z1.400 F802.4 E22.95382
+M108 R2.5 T0
+G1 X-20.432 Y15.962 Z1.400 F4308.6 E24.27609
+G1 X20.939 Y-7.703 Z1.400 F3545.4 E25.33030
+G1 X21.377 Y23.796 Z1.400 F4632.3 E26.24243
+G1 X-14.964 Y-16.943 Z1.400 F2992.0 E26.54803
+G1 X10.898 Y13.029 Z1.400 F2061.5 E26.67363
+M103 T0 (extruder off)
+(<layer> 1.600 )
+G1 X-20.112 Y13.794 Z1.600 F3000.0
+M101 T0 (extruder on, forward)
+G1 X-24.576 Y-14.689 Z1.600 F1024.4 E27.48368
+G1 X28.489 Y28.154 Z1.600 F3191.0 E27.65507
+G1 X-25.080 Y21.058 Z1.600 F1612.2 E28.70069
+G1 X24.206 Y-6.166 Z1.600 F4422.4 E30.11368
+G1 X-0.722 Y-17.279 Z1.600 F2411.3 E31.06617
+G1 X9.631 Y-13.340 Z1.600 F2191.2 E32.43464
+G1 X1.702 Y4.745 Z1.600 F729.4 E33.87636
+G1 X-14.376 Y-19.629 Z1.600 F1223.3 E34.27761
+M103 T0 (extruder off)
+M73 P100 (end build progress )
+M104 S0 T0 (turn off extruder)
+M109 S0 T0 (turn off HBP)
+(**** end of end.gcode ****)
@@ -0,0 +1,154 @@
+#!/bin/sh
+# Golden output tests for DualExtrude
+#
+# Usage: tests/run_tests.sh [path/to/DualExtrude]
+#
+# Each NAME.gcode is converted with no diameters and with 1.75 2.0,
+# and has to match NAME.gold and NAME-2.0.gold, with every option
+# that should not change the output. --binary output is checked
+# against the same golden files with bincheck.py, when python3 is
+# there. Then --bench default has to convert at BENCH_MIN MB/s or
+# better (default 20, 0 skips it). --from-layer is checked by
+# converting from a layer again with other diameters, and --batch
+# with all of them in one list.
+#
+# right, left, crlf and temp golden files were made by DualExtrude 2.2,
+# temp has M104 S values too big for an int.
+# g92, relative and longline were made by this version, 2.2 copied
+# G92 E and M83 lines as they were and split lines over 1000 chars.
+
+DE=${1:-./DualExtrude}
+BENCH_MIN=${BENCH_MIN:-20}
+DIR=$(cd "$(dirname "$0")" && pwd)
+TMP=$(mktemp -d) || exit 1
+trap 'rm -rf "$TMP"' EXIT
+
+case "$DE" in
+/*) ;;
+*) DE=$(pwd)/$DE ;;
+esac
+if [ ! -x "$DE" ]; then
+	echo "Can't run $DE, build it first or give its path"
+	exit 1
+fi
+
+Pass=0
+Fail=0
+
+# Check NAME OPTIONS... - Converts NAME.gcode both ways with OPTIONS
+Check()
+{
+	Name=$1
+	shift
+	if "$DE" "$@" --expect "$DIR/$Name.gold" "$DIR/$Name.gcode" "$TMP/out.gcode" > "$TMP/log" 2>&1 &&
+		"$DE" "$@" --expect "$DIR/$Name-2.0.gold" "$DIR/$Name.gcode" 1.75 "$TMP/out.gcode" 2.0 > "$TMP/log" 2>&1
+	then
+		Pass=$((Pass + 1))
+	else
+		Fail=$((Fail + 1))
+		echo "FAIL: $Name $*"
+		cat "$TMP/log"
+	fi
+	rm -f "$TMP/out.gcode"*
+}
+
+# CheckBinary NAME - Converts NAME.gcode both ways with --binary
+CheckBinary()
+{
+	if "$DE" --binary "$DIR/$1.gcode" "$TMP/out.bin" > "$TMP/log" 2>&1 &&
+		python3 "$DIR/bincheck.py" "$TMP/out.bin" "$DIR/$1.gold" >> "$TMP/log" 2>&1 &&
+		"$DE" --binary "$DIR/$1.gcode" 1.75 "$TMP/out.bin" 2.0 > "$TMP/log" 2>&1 &&
+		python3 "$DIR/bincheck.py" "$TMP/out.bin" "$DIR/$1-2.0.gold" >> "$TMP/log" 2>&1
+	then
+		Pass=$((Pass + 1))
+	else
+		Fail=$((Fail + 1))
+		echo "FAIL: $1 --binary"
+		cat "$TMP/log"
+	fi
+	rm -f "$TMP/out.bin"
+}
+
+for In in "$DIR"/*.gcode
+do
+	Name=$(basename "$In" .gcode)
+	Check "$Name"
+	Check "$Name" --single-pass
+	Check "$Name" --quick-check
+	Check "$Name" --verify
+	Check "$Name" --threads 4
+	Check "$Name" --verify --threads 4
+	Check "$Name" --arena
+	Check "$Name" --read-thread
+	Check "$Name" --write-thread --outbuf 1
+	if command -v python3 > /dev/null 2>&1; then
+		CheckBinary "$Name"
+	fi
+done
+
+# CheckLayers NAME - Converts NAME.gcode again from layer 5 with other
+# diameters, then back, which has to give the same files as converting
+# it that way to start with
+CheckLayers()
+{
+	if "$DE" --index "$DIR/$1.gcode" 1.75 "$TMP/once.gcode" 2.0 > "$TMP/log" 2>&1 &&
+		"$DE" --index --from-layer 5 "$DIR/$1.gcode" 1.75 "$TMP/once.gcode" 1.6 >> "$TMP/log" 2>&1 &&
+		"$DE" --index "$DIR/$1.gcode" 1.75 "$TMP/again.gcode" 2.0 >> "$TMP/log" 2>&1 &&
+		"$DE" --index --from-layer 5 "$DIR/$1.gcode" 1.75 "$TMP/again.gcode" 1.8 >> "$TMP/log" 2>&1 &&
+		"$DE" --index --from-layer 5 "$DIR/$1.gcode" 1.75 "$TMP/again.gcode" 2.0 >> "$TMP/log" 2>&1 &&
+		"$DE" --index --from-layer 5 "$DIR/$1.gcode" 1.75 "$TMP/again.gcode" 1.6 >> "$TMP/log" 2>&1 &&
+		cmp "$TMP/once.gcode" "$TMP/again.gcode" >> "$TMP/log" 2>&1 &&
+		cmp "$TMP/once.gcode.idx" "$TMP/again.gcode.idx" >> "$TMP/log" 2>&1 &&
+		"$DE" --index --from-layer 5 "$DIR/$1.gcode" 1.75 "$TMP/again.gcode" 2.0 >> "$TMP/log" 2>&1 &&
+		"$DE" --expect "$DIR/$1-2.0.gold" --index --from-layer 5 "$DIR/$1.gcode" 1.75 "$TMP/again.gcode" 2.0 >> "$TMP/log" 2>&1
+	then
+		Pass=$((Pass + 1))
+	else
+		Fail=$((Fail + 1))
+		echo "FAIL: $1 --from-layer"
+		cat "$TMP/log"
+	fi
+	rm -f "$TMP/once.gcode"* "$TMP/again.gcode"*
+}
+
+CheckLayers right
+CheckLayers g92
+
+# Every file both ways in one --batch list, in command line order
+rm -f "$TMP/list"
+for In in "$DIR"/*.gcode
+do
+	Name=$(basename "$In" .gcode)
+	echo "$In $TMP/$Name.gcode" >> "$TMP/list"
+	echo "$In 1.75 $TMP/$Name-2.0.gcode 2.0" >> "$TMP/list"
+done
+Ok=0
+if "$DE" --threads 4 --batch "$TMP/list" > "$TMP/log" 2>&1; then
+	Ok=1
+	for In in "$DIR"/*.gcode
+	do
+		Name=$(basename "$In" .gcode)
+		cmp "$DIR/$Name.gold" "$TMP/$Name.gcode" >> "$TMP/log" 2>&1 || Ok=0
+		cmp "$DIR/$Name-2.0.gold" "$TMP/$Name-2.0.gcode" >> "$TMP/log" 2>&1 || Ok=0
+	done
+fi
+if [ "$Ok" -eq 1 ]; then
+	Pass=$((Pass + 1))
+else
+	Fail=$((Fail + 1))
+	echo "FAIL: --batch"
+	cat "$TMP/log"
+fi
+
+if [ "$BENCH_MIN" -gt 0 ]; then
+	if "$DE" --bench "default,min=$BENCH_MIN" > "$TMP/log" 2>&1; then
+		Pass=$((Pass + 1))
+	else
+		Fail=$((Fail + 1))
+		echo "FAIL: --bench default,min=$BENCH_MIN"
+		cat "$TMP/log"
+	fi
+fi
+
+echo "$Pass passed, $Fail failed"
+[ "$Fail" -eq 0 ]
@@ -0,0 +1,151 @@
+(**** This is a build header ****)
+(**** Generated by MakerWare style test input ****)
+M103 T0 (disable extruder)
+M73 P0 (enable build progress)
+G21 (set units to mm)
+G90 (set positioning to absolute)
+M109 S110 T0 (set HBP temperature)
+M104 S99999999999999999999 T0 (set extruder temperature)
+M104 S-99999999999999999999 T0
+M104 S4294967526 T0
+M104 S230 T0
+(**** end of start.gcode ****)
+M108 R3.0 T0 (set extruder speed)
+M6 T0 (wait for toolhead parts, nozzle, HBP, etc., to reach temperature)
+G1 X-10.0 Y-10.0 Z0.2 F3300.0 (move to waiting position)
+(<layer> 0.200 )
+G1 X-10.570 Y-20.949 Z0.200 F3000.0
+M101 T0 (extruder on, forward)
+G1 X19.276 Y-24.352 Z0.200 F3047.7 E0.12002
+G1 X-24.843 Y-4.910 Z0.200 F1610.8 E0.48133
+G1 X3.927 Y26.847 Z0.200 F3248.6 E0.61704
+G1 X5.132 Y-27.025 Z0.200 F1528.5 E0.75674
+G1 X-4.852 Y2.441 Z0.200 F2997.8 E0.99984
+G1 X-23.817 Y4.272 Z0.200 F1389.1 E2.03875
+M108 R3.1 T0
+G1 X7.141 Y-0.215 Z0.200 F2833.2 E2.90708
+G1 X25.406 Y-8.305 Z0.200 F1643.4 E3.63220
+G1 X-25.089 Y-11.985 Z0.200 F2679.5 E4.81295
+G1 X6.538 Y-25.608 Z0.200 F2750.1 E5.51376
+G1 X25.996 Y-4.698 Z0.200 F4640.5 E6.05975
+M108 R2.7 T0
+G1 X19.101 Y-9.593 Z0.200 F2070.7 E7.25393
+G1 X-25.874 Y-24.384 Z0.200 F1733.7 E8.45943
+M103 T0 (extruder off)
+(<layer> 0.400 )
+G1 X-26.100 Y13.870 Z0.400 F3000.0
+M101 T0 (extruder on, forward)
+G1 X29.586 Y19.315 Z0.400 F1795.3 E9.44776
+G1 X-28.646 Y-2.298 Z0.400 F1305.8 E10.46731
+M108 R1.2 T0
+G1 X-22.240 Y-15.143 Z0.400 F2242.0 E11.63125
+G1 X-3.049 Y2.966 Z0.400 F4310.2 E11.79809
+G1 X-13.295 Y-5.082 Z0.400 F2106.8 E13.10087
+G1 X-20.945 Y-19.427 Z0.400 F1574.2 E14.53958
+G1 X5.347 Y-14.235 Z0.400 F617.2 E15.29277
+G1 X3.980 Y27.186 Z0.400 F3500.1 E15.87819
+G1 X10.572 Y-26.760 Z0.400 F4378.0 E16.82370
+G1 X17.872 Y-6.457 Z0.400 F2275.7 E18.14174
+M108 R2.9 T0
+M103 T0 (extruder off)
+(<layer> 0.600 )
+G1 X-26.265 Y-25.959 Z0.600 F3000.0
+M101 T0 (extruder on, forward)
+G1 X-23.404 Y6.044 Z0.600 F1030.0 E18.83065
+G1 X26.937 Y6.824 Z0.600 F895.3 E19.65875
+G1 X8.065 Y27.328 Z0.600 F3129.6 E20.25428
+G1 X-0.716 Y28.669 Z0.600 F2617.7 E20.47155
+G1 X14.980 Y14.421 Z0.600 F2610.2 E20.73052
+G1 X-17.687 Y27.121 Z0.600 F2119.4 E21.52920
+G1 X15.489 Y-12.115 Z0.600 F3300.3 E22.90471
+M108 R3.5 T0
+G1 X24.496 Y-8.658 Z0.600 F1535.7 E23.70639
+G1 X8.187 Y6.794 Z0.600 F3911.3 E24.48530
+M103 T0 (extruder off)
+(<layer> 0.800 )
+G1 X-18.291 Y-15.637 Z0.800 F3000.0
+M101 T0 (extruder on, forward)
+G1 X-16.396 Y1.058 Z0.800 F2093.4 E25.60811
+M108 R1.1 T0
+G1 X-14.450 Y11.551 Z0.800 F4617.4 E26.06327
+G1 X29.282 Y27.300 Z0.800 F2131.5 E27.47195
+G1 X-18.198 Y-17.738 Z0.800 F3221.1 E27.85088
+G1 X-1.232 Y9.179 Z0.800 F3958.5 E29.11951
+M108 R3.0 T0
+G1 X16.938 Y15.008 Z0.800 F2607.7 E30.48869
+G1 X-10.049 Y18.049 Z0.800 F4681.0 E31.68293
+G1 X26.808 Y13.488 Z0.800 F1314.0 E32.31494
+M108 R1.5 T0
+G1 X18.390 Y-21.230 Z0.800 F4071.3 E33.67698
+G1 X-8.976 Y2.920 Z0.800 F1150.1 E34.68002
+M108 R3.9 T0
+G1 X1.595 Y26.017 Z0.800 F2422.0 E35.67205
+M103 T0 (extruder off)
+(<layer> 1.000 )
+G1 X19.569 Y-17.337 Z1.000 F3000.0
+M101 T0 (extruder on, forward)
+G1 X0.070 Y15.821 Z1.000 F1969.2 E0.35853
+G1 X-26.346 Y14.395 Z1.000 F4370.4 E1.61811
+G1 X1.006 Y19.628 Z1.000 F4288.3 E2.84993
+M108 R1.5 T0
+G1 X22.368 Y16.590 Z1.000 F3155.9 E3.64022
+G1 X-21.506 Y7.146 Z1.000 F1105.4 E3.90744
+M108 R3.0 T0
+G1 X-1.051 Y16.589 Z1.000 F4309.6 E4.72699
+M108 R1.6 T0
+G1 X-24.135 Y-2.869 Z1.000 F717.0 E4.83818
+G1 X-10.463 Y28.402 Z1.000 F3145.8 E4.98006
+G1 X0.489 Y18.442 Z1.000 F2732.6 E5.43198
+G1 X22.559 Y25.669 Z1.000 F4475.7 E6.24064
+M103 T0 (extruder off)
+M104 S225 T0
+(<layer> 1.200 )
+G1 X-17.845 Y-3.148 Z1.200 F3000.0
+M101 T0 (extruder on, forward)
+G1 X-3.473 Y-25.647 Z1.200 F1610.7 E6.46699
+M108 R3.0 T0
+G1 X23.822 Y-20.733 Z1.200 F3607.7 E7.65370
+G1 X22.970 Y28.053 Z1.200 F1522.3 E7.91102
+G1 X-0.764 Y29.392 Z1.200 F4096.3 E8.53849
+G1 X0.936 Y-9.653 Z1.200 F1422.1 E9.21420
+G1 X-28.831 Y3.243 Z1.200 F2449.9 E10.31131
+M108 R2.0 T0
+G1 X0.736 Y-26.143 Z1.200 F4737.3 E11.26601
+G1 X-23.713 Y-14.066 Z1.200 F766.3 E12.72497
+G1 X-22.227 Y-4.665 Z1.200 F4427.9 E13.16711
+G1 X-21.038 Y25.150 Z1.200 F2996.5 E13.59210
+G1 X-26.548 Y11.292 Z1.200 F2386.3 E13.77182
+M108 R3.8 T0
+M103 T0 (extruder off)
+(<layer> 1.400 )
+G1 X8.066 Y18.098 Z1.400 F3000.0
+M101 T0 (extruder on, forward)
+G1 X-16.656 Y-14.133 Z1.400 F1111.0 E14.70368
+M108 R4.0 T0
+G1 X24.926 Y7.302 Z1.400 F781.5 E15.35943
+G1 X28.153 Y-14.286 Z1.400 F1360.8 E16.76971
+G1 X1.865 Y-17.648 Z1.400 F2471.9 E17.73128
+G1 X18.221 Y29.670 Z1.400 F755.2 E18.17354
+M108 R2.5 T0
+G1 X0.854 Y-15.259 Z1.400 F2477.6 E19.64172
+G1 X9.391 Y2.754 Z1.400 F4332.6 E20.63437
+G1 X-17.089 Y-16.226 Z1.400 F1434.2 E21.13065
+M103 T0 (extruder off)
+(<layer> 1.600 )
+G1 X13.731 Y-21.617 Z1.600 F3000.0
+M101 T0 (extruder on, forward)
+G1 X20.219 Y-29.145 Z1.600 F3226.9 E22.60438
+G1 X-26.676 Y9.914 Z1.600 F2199.7 E23.27896
+G1 X5.927 Y11.561 Z1.600 F790.0 E24.73681
+G1 X-29.783 Y-8.152 Z1.600 F1981.5 E25.17691
+G1 X-27.933 Y22.943 Z1.600 F1515.0 E25.69603
+G1 X-24.967 Y-13.264 Z1.600 F3355.3 E26.23227
+G1 X-24.549 Y19.023 Z1.600 F1204.2 E27.40781
+G1 X-12.021 Y7.780 Z1.600 F954.8 E28.02908
+G1 X-20.685 Y23.568 Z1.600 F3893.0 E29.31629
+G1 X13.241 Y-0.349 Z1.600 F1793.5 E30.47454
+M103 T0 (extruder off)
+M73 P100 (end build progress )
+M104 S0 T0 (turn off extruder)
+M109 S0 T0 (turn off HBP)
+(**** end of end.gcode ****)